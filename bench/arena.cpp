@@ -0,0 +1,51 @@
+#include <str/arena.h>
+#include <str/str.h>
+
+#include "bench.h"
+
+#include <cstdio>
+
+// Request-like workload : build header and body pieces, then drop them.
+static void request(StrStr * strs, int cnt)
+{
+    static char const HDR[] = "x-request-header-with-long-name: some fairly long value";
+    for(int i = 0; i < cnt; ++i)
+    {
+        str_str_init_empty(strs + i);
+        str_str_cat(strs + i, str_ref(HDR, 16 + i%32));
+        if(i%8 == 0)
+            for(int j = 0; j < 8; ++j)
+                str_str_cat(strs + i, str_ref(HDR, sizeof(HDR)-1));
+    }
+    bench_keep(strs);
+    for(int i = 0; i < cnt; ++i)
+        str_str_kill(strs + i);
+}
+
+BENCH("arena vs malloc per request")
+{
+    int const REQUESTS = 100000, STRINGS = 64;
+    StrStr strs[STRINGS];
+
+    double t = bench_time([&]
+    {
+        for(int r = 0; r < REQUESTS; ++r)
+            request(strs, STRINGS);
+    });
+    bench_report("malloc, 64 strings/request", t, REQUESTS);
+
+    StrArena arena;
+    str_arena_init(&arena, 0);
+    StrAlloc const * old = str_alloc_set_thread(str_arena_allocator(&arena));
+    t = bench_time([&]
+    {
+        for(int r = 0; r < REQUESTS; ++r)
+        {
+            request(strs, STRINGS);
+            str_arena_reset(&arena);
+        }
+    });
+    str_alloc_set_thread(old);
+    str_arena_kill(&arena);
+    bench_report("arena, 64 strings/request", t, REQUESTS);
+}
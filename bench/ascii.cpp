@@ -0,0 +1,100 @@
+#include <str/fmt.h>
+
+#include "bench.h"
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+static StrRef bench_trim_isspace(StrRef ref)
+{
+    while((ref.len > 0) && std::isspace((unsigned char)ref.ptr[0]))
+    {
+        ++ref.ptr;
+        --ref.len;
+    }
+    while((ref.len > 0) && std::isspace((unsigned char)ref.ptr[ref.len-1]))
+        --ref.len;
+    return ref;
+}
+
+BENCH("str_ref_trim_spaces")
+{
+    // fixed-width fields, values right-aligned with padding
+    for(size_t width : { size_t(8), size_t(32), size_t(256) })
+    {
+        std::vector<std::string> fields;
+        unsigned x = 1;
+        for(int i = 0; i < 1024; ++i)
+        {
+            x = x*1103515245u + 12345u;
+            size_t const len = 1 + (x>>16) % (width/2);
+            fields.push_back(std::string(width - len, ' ') + std::string(len, 'v') + "  ");
+        }
+        size_t const n = (size_t(1)<<28)/(width*fields.size());
+        double const bytes = double(n)*fields.size()*(width + 2);
+        char what[64];
+        size_t sum = 0;
+
+        double t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+                for(std::string const & f : fields)
+                    sum += str_ref_trim_spaces(str_ref(f.data(), f.size())).len;
+        });
+        std::snprintf(what, sizeof(what), "%4zuB, str_ref_trim_spaces", width);
+        bench_report(what, t, n*fields.size(), bytes);
+
+        t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+                for(std::string const & f : fields)
+                    sum += bench_trim_isspace(str_ref(f.data(), f.size())).len;
+        });
+        std::snprintf(what, sizeof(what), "%4zuB, isspace loop", width);
+        bench_report(what, t, n*fields.size(), bytes);
+        bench_keep(sum);
+    }
+}
+
+BENCH("str_cpy_tolower")
+{
+    // header names and hostnames, then long text
+    for(size_t size : { size_t(16), size_t(64), size_t(4096) })
+    {
+        std::string src;
+        while(src.size() < size)
+            src += "X-Forwarded-For.Example.COM/";
+        src.resize(size);
+        std::string dst(size + 1, '\0');
+        size_t const n = (size_t(1)<<30)/size;
+        char what[64];
+        size_t sum = 0;
+
+        double t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+            {
+                char * p = &dst[0];
+                size_t cap = dst.size();
+                sum += str_cpy_tolower(&p, &cap, str_ref(src.data(), src.size()));
+                bench_keep(dst[0]);
+            }
+        });
+        std::snprintf(what, sizeof(what), "%5zuB, str_cpy_tolower", size);
+        bench_report(what, t, n, double(size)*n);
+
+        t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+            {
+                for(size_t j = 0; j < size; ++j)
+                    dst[j] = char(std::tolower((unsigned char)src[j]));
+                bench_keep(dst[0]);
+            }
+        });
+        std::snprintf(what, sizeof(what), "%5zuB, tolower loop", size);
+        bench_report(what, t, n, double(size)*n);
+        bench_keep(sum);
+    }
+}
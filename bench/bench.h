@@ -0,0 +1,75 @@
+#ifndef LIBSTR_BENCH_H_INCLUDED
+#define LIBSTR_BENCH_H_INCLUDED
+
+#include <chrono>
+#include <cstdio>
+
+/** \brief Minimal benchmark registry.
+ *
+ * BENCH("name")
+ * {
+ *     double t = bench_time([&]{ ... });
+ *     bench_report("what", t, ops, bytes);
+ * }
+ *
+ * Benchmarks are run by bench/main.cpp, optionally filtered by name prefix.
+ */
+struct Bench
+{
+    char const * name;
+    void (*fun)();
+    Bench * next;
+
+    static Bench *& list() { static Bench * head = nullptr; return head; }
+
+    Bench(char const * n, void (*f)()) : name(n), fun(f), next(nullptr)
+    {
+        // keep registration order
+        Bench ** tail = &list();
+        while(*tail)
+            tail = &(*tail)->next;
+        *tail = this;
+    }
+};
+
+#define BENCH_CAT_(a, b) a##b
+#define BENCH_CAT(a, b) BENCH_CAT_(a, b)
+#define BENCH(name)                                                            \
+    static void BENCH_CAT(bench_fun_, __LINE__)();                             \
+    static Bench BENCH_CAT(bench_reg_, __LINE__)(name, BENCH_CAT(bench_fun_, __LINE__)); \
+    static void BENCH_CAT(bench_fun_, __LINE__)()
+
+/** \brief Wall time of one call in seconds.
+ */
+template<typename F>
+double bench_time(F f)
+{
+    auto const beg = std::chrono::steady_clock::now();
+    f();
+    auto const end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - beg).count();
+}
+
+/** \brief Keep value alive, prevent optimizing the computation out.
+ */
+template<typename T>
+inline void bench_keep(T const & x)
+{
+    __asm__ __volatile__("" : : "g"(&x) : "memory");
+}
+
+/** \brief Print one result line.
+ *
+ * bytes == 0 omits the throughput column.
+ */
+inline void bench_report(char const * what, double sec, double ops, double bytes = 0)
+{
+    if(bytes > 0)
+        std::printf("  %-40s %10.3f ms %10.2f ns/op %8.2f GB/s\n",
+            what, sec*1e3, sec*1e9/ops, bytes/sec/1e9);
+    else
+        std::printf("  %-40s %10.3f ms %10.2f ns/op\n",
+            what, sec*1e3, sec*1e9/ops);
+}
+
+#endif//LIBSTR_BENCH_H_INCLUDED
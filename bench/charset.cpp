@@ -0,0 +1,128 @@
+#include <str/charset.h>
+
+#include "bench.h"
+
+#include <cstring>
+#include <string>
+
+static void bench_split(char const * name, std::string const & text)
+{
+    std::printf(" %s\n", name);
+    StrCharSet set;
+    str_charset_init(&set, str_ref_cstr("\t\r\n"));
+    size_t const n = 8;
+    double const bytes = double(text.size())*n;
+    size_t sum = 0;
+
+    double t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+        {
+            StrSplit split;
+            str_split_init(&split, str_ref(text.data(), text.size()), &set);
+            for(StrRef field; str_split_next(&split, &field); )
+                sum += field.len;
+        }
+    });
+    bench_report("str_split_next", t, n, bytes);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+        {
+            StrRef ref = str_ref(text.data(), text.size());
+            StrRef fields[256];
+            for(size_t cnt; (cnt = str_ref_split_any(&ref, &set, fields, 256)); )
+                for(size_t j = 0; j < cnt; ++j)
+                    sum += fields[j].len;
+        }
+    });
+    bench_report("str_ref_split_any", t, n, bytes);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+        {
+            // strcspn stops at NUL, the text has none
+            for(char const * p = text.c_str(); ; )
+            {
+                size_t const len = strcspn(p, "\t\r\n");
+                sum += len;
+                if(!p[len])
+                    break;
+                p += len + 1;
+            }
+        }
+    });
+    bench_report("strcspn", t, n, bytes);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+        {
+            size_t beg = 0;
+            for(size_t j = 0; j < text.size(); ++j)
+            {
+                char const c = text[j];
+                if(c == '\t' || c == '\r' || c == '\n')
+                {
+                    sum += j - beg;
+                    beg = j + 1;
+                }
+            }
+            sum += text.size() - beg;
+        }
+    });
+    bench_report("byte loop", t, n, bytes);
+    bench_keep(sum);
+}
+
+BENCH("str_split")
+{
+    // log-like lines, fields separated by tabs, a few long free-text fields
+    std::string text;
+    unsigned x = 1;
+    while(text.size() < size_t(16)<<20)
+    {
+        x = x*1103515245u + 12345u;
+        text.append("2024-01-01T00:00:00Z\tINFO\tworker-").append(std::to_string(x % 64))
+            .append("\tGET /api/v1/items/").append(std::to_string(x))
+            .append("\t200\t").append((x>>16) % 4 ? "ok" : "request took longer than expected, retried")
+            .append("\r\n");
+    }
+    bench_split("short fields", text);
+
+    // short key and a long message per line
+    text.clear();
+    while(text.size() < size_t(16)<<20)
+    {
+        x = x*1103515245u + 12345u;
+        text.append(std::to_string(x)).append("\t").append(200 + (x>>16) % 200, 'm').append("\r\n");
+    }
+    bench_split("long fields", text);
+}
+
+BENCH("str_ref_find_any short")
+{
+    // one log field, AVX2 loop runs once, the rest is the SSSE3 tail
+    std::string const text = "2024-01-01T00:00:00Z INFO worker-17 GET /api\t";
+    StrCharSet set;
+    str_charset_init(&set, str_ref_cstr("\t\r\n"));
+    size_t const n = size_t(1)<<24;
+    size_t sum = 0;
+
+    double t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i, bench_keep(i)) // no hoisting of pure calls
+            sum += str_ref_find_any(str_ref(text.data(), text.size()), &set);
+    });
+    bench_report("str_ref_find_any", t, n, double(text.size())*n);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i, bench_keep(i))
+            sum += strcspn(text.c_str(), "\t\r\n");
+    });
+    bench_report("strcspn", t, n, double(text.size())*n);
+    bench_keep(sum);
+}
@@ -0,0 +1,97 @@
+#include <str/intern.h>
+
+#include "bench.h"
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+BENCH("str_intern headers")
+{
+    // label values of a metrics pipeline, few distinct among many
+    static int const DISTINCT = 2000;
+    static int const N = 4000000;
+    std::vector<std::string> values;
+    for(int i = 0; i < DISTINCT; ++i)
+        values.push_back("service-" + std::to_string(i % 50) + "/endpoint-" + std::to_string(i));
+    std::vector<std::string> input;
+    input.reserve(N);
+    for(int i = 0; i < N; ++i)
+        input.push_back(values[(i * 2654435761u) % DISTINCT]);
+
+    {
+        std::vector<StrStr> strs(N);
+        size_t bytes = 0;
+        double const t = bench_time([&]
+        {
+            for(int i = 0; i < N; ++i)
+            {
+                str_str_init_copy(&strs[i], str_ref(input[i].data(), input[i].size()));
+                if(input[i].size() > STR_SSO_CAP)
+                    bytes += input[i].size() + 1;
+            }
+        });
+        char what[64];
+        std::snprintf(what, sizeof(what), "copies (%zu kB contents)", bytes >> 10);
+        bench_report(what, t, N);
+        for(auto & str : strs)
+            str_str_kill(&str);
+    }
+
+    StrIntern intern;
+    str_intern_init(&intern);
+    std::vector<StrRef> canon(N);
+    {
+        double const t = bench_time([&]
+        {
+            for(int i = 0; i < N; ++i)
+                canon[i] = str_intern(&intern, str_ref(input[i].data(), input[i].size()));
+        });
+        StrInternStats stats;
+        str_intern_stats(&intern, &stats);
+        char what[64];
+        std::snprintf(what, sizeof(what), "intern (%zu kB memory)", stats.memory >> 10);
+        bench_report(what, t, N);
+    }
+
+    for(int threads : { 2, 4 })
+    {
+        double const t = bench_time([&]
+        {
+            std::vector<std::thread> pool;
+            for(int k = 0; k < threads; ++k)
+                pool.emplace_back([&, k]
+                {
+                    size_t found = 0;
+                    for(int i = k; i < N; i += threads)
+                        found += str_intern(&intern, str_ref(input[i].data(), input[i].size())).ptr == canon[i].ptr;
+                    bench_keep(found);
+                });
+            for(auto & th : pool)
+                th.join();
+        });
+        char what[64];
+        std::snprintf(what, sizeof(what), "intern, %d threads", threads);
+        bench_report(what, t, N);
+    }
+
+    // equality of interned strings is pointer comparison
+    size_t eq = 0;
+    double const t = bench_time([&]
+    {
+        for(int i = 1; i < N; ++i)
+            eq += canon[i].ptr == canon[i-1].ptr;
+    });
+    double const u = bench_time([&]
+    {
+        for(int i = 1; i < N; ++i)
+            eq += (input[i].size() == input[i-1].size())
+                && !std::memcmp(input[i].data(), input[i-1].data(), input[i].size());
+    });
+    bench_keep(eq);
+    bench_report("equality, pointer", t, N);
+    bench_report("equality, memcmp", u, N);
+
+    str_intern_kill(&intern);
+}
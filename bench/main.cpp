@@ -0,0 +1,19 @@
+#include "bench.h"
+
+#include <cstring>
+
+// Usage : bench [name-prefix ...]
+int main(int argc, char ** argv)
+{
+    for(Bench * b = Bench::list(); b; b = b->next)
+    {
+        bool run = argc < 2;
+        for(int i = 1; i < argc; ++i)
+            run = run || (std::strncmp(b->name, argv[i], std::strlen(argv[i])) == 0);
+        if(!run)
+            continue;
+        std::printf("%s\n", b->name);
+        b->fun();
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <str/map.h>
+
+#include "bench.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+BENCH("str_map vs unordered_map")
+{
+    static int const N = 1000000;
+    // inline in StrStr, inline in neither, long
+    for(size_t len : { size_t(12), size_t(24), size_t(64) })
+    {
+        std::vector<std::string> keys;
+        keys.reserve(N);
+        for(int i = 0; i < N; ++i)
+        {
+            char key[16];
+            std::snprintf(key, sizeof(key), "k%08x", i * 2654435761u);
+            keys.push_back(key);
+            keys.back().resize(len, '.');
+        }
+        char what[64];
+
+        StrMap map;
+        str_map_init(&map);
+        double t = bench_time([&]
+        {
+            for(int i = 0; i < N; ++i)
+                *str_map_insert(&map, str_ref(keys[i].data(), keys[i].size()), nullptr) = &keys[i];
+        });
+        std::snprintf(what, sizeof(what), "%2zuB, str_map insert", len);
+        bench_report(what, t, N);
+
+        std::unordered_map<std::string, void *> umap;
+        t = bench_time([&]
+        {
+            for(int i = 0; i < N; ++i)
+                umap[keys[i]] = &keys[i];
+        });
+        std::snprintf(what, sizeof(what), "%2zuB, unordered_map insert", len);
+        bench_report(what, t, N);
+
+        // lookups in different order than insertion
+        size_t found = 0;
+        t = bench_time([&]
+        {
+            for(int i = 0; i < N; ++i)
+            {
+                std::string const & key = keys[(i * 7919u) % N];
+                found += str_map_find(&map, str_ref(key.data(), key.size())) != nullptr;
+            }
+        });
+        std::snprintf(what, sizeof(what), "%2zuB, str_map find", len);
+        bench_report(what, t, N);
+
+        t = bench_time([&]
+        {
+            for(int i = 0; i < N; ++i)
+                found += umap.count(keys[(i * 7919u) % N]);
+        });
+        std::snprintf(what, sizeof(what), "%2zuB, unordered_map find", len);
+        bench_report(what, t, N);
+
+        // keys arrive as pointer and length, e.g. parsed from a buffer
+        t = bench_time([&]
+        {
+            for(int i = 0; i < N; ++i)
+            {
+                std::string const & key = keys[(i * 7919u) % N];
+                found += umap.count(std::string(key.data(), key.size()));
+            }
+        });
+        std::snprintf(what, sizeof(what), "%2zuB, unordered_map find, temp key", len);
+        bench_report(what, t, N);
+        bench_keep(found);
+
+        str_map_kill(&map);
+    }
+}
@@ -0,0 +1,133 @@
+#include <str/ref_b16.h>
+
+#include "bench.h"
+
+#include <string>
+
+// byte loop with two lookups per byte, as before SIMD encoding
+static void bench_encode_b16_loop(char * dst, StrRef ref)
+{
+    static char const HEX[] = "0123456789abcdef";
+    for(size_t i = 0; i < ref.len; ++i)
+    {
+        dst[2*i  ] = HEX[(ref.ptr[i]>>4)&0xf];
+        dst[2*i+1] = HEX[(ref.ptr[i]   )&0xf];
+    }
+    dst[2*ref.len] = '\0';
+}
+
+BENCH("str_encode_b16")
+{
+    // digests, ids and blobs
+    for(size_t size : { size_t(16), size_t(32), size_t(1024), size_t(1)<<20 })
+    {
+        std::string src;
+        unsigned x = 1;
+        while(src.size() < size)
+        {
+            x = x*1103515245u + 12345u;
+            src.push_back(char(x>>16));
+        }
+        std::string dst(2*size + 1, '\0');
+        size_t const n = (size_t(1)<<30)/size;
+        char what[64];
+
+        double t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+            {
+                str_encode_b16(&dst[0], str_ref(src.data(), size));
+                bench_keep(dst[0]);
+            }
+        });
+        std::snprintf(what, sizeof(what), "%8zuB, str_encode_b16", size);
+        bench_report(what, t, n, double(size)*n);
+
+        t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+            {
+                bench_encode_b16_loop(&dst[0], str_ref(src.data(), size));
+                bench_keep(dst[0]);
+            }
+        });
+        std::snprintf(what, sizeof(what), "%8zuB, byte loop", size);
+        bench_report(what, t, n, double(size)*n);
+    }
+}
+
+// per character switch and early return, as before SIMD decoding
+static int bench_b16_dec_char(char x)
+{
+    switch(x)
+    {
+        case '0' ... '9' :
+            return x - '0';
+        case 'A' ... 'F' :
+            return x - 'A' + 10;
+        case 'a' ... 'f' :
+            return x - 'a' + 10;
+        default :
+            return -1;
+    }
+}
+
+static bool bench_decode_b16_loop(char * dst, StrRef ref)
+{
+    if(ref.len%2 != 0)
+        return false;
+    for(size_t i = 0; i < ref.len/2; ++i)
+    {
+        int const a = bench_b16_dec_char(ref.ptr[2*i]);
+        if(a < 0)
+            return false;
+        int const b = bench_b16_dec_char(ref.ptr[2*i+1]);
+        if(b < 0)
+            return false;
+        dst[i] = char((a<<4) + b);
+    }
+    dst[ref.len/2] = '\0';
+    return true;
+}
+
+BENCH("str_decode_b16")
+{
+    // signatures and payloads
+    for(size_t size : { size_t(32), size_t(64), size_t(2048), size_t(2)<<20 })
+    {
+        std::string src;
+        unsigned x = 1;
+        while(src.size() < size)
+        {
+            x = x*1103515245u + 12345u;
+            src.push_back("0123456789abcdefABCDEF"[(x>>16) % 22]);
+        }
+        std::string dst(size/2 + 1, '\0');
+        size_t const n = (size_t(1)<<30)/size;
+        char what[64];
+        size_t sum = 0;
+
+        double t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+            {
+                sum += str_decode_b16(&dst[0], str_ref(src.data(), size));
+                bench_keep(dst[0]);
+            }
+        });
+        std::snprintf(what, sizeof(what), "%8zuB, str_decode_b16", size);
+        bench_report(what, t, n, double(size)*n);
+
+        t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+            {
+                sum += bench_decode_b16_loop(&dst[0], str_ref(src.data(), size));
+                bench_keep(dst[0]);
+            }
+        });
+        std::snprintf(what, sizeof(what), "%8zuB, switch loop", size);
+        bench_report(what, t, n, double(size)*n);
+        bench_keep(sum);
+    }
+}
@@ -0,0 +1,102 @@
+#include <str/ref.h>
+
+#include "bench.h"
+
+#include <string>
+#include <vector>
+
+#include <strings.h>
+
+BENCH("str_ref_cmp_eq_ci")
+{
+    // incoming header names looked up in a list of known names
+    std::vector<std::string> const known = { "Host", "User-Agent", "Accept", "Accept-Encoding",
+        "Accept-Language", "Connection", "Content-Length", "Content-Type", "Cookie",
+        "Authorization", "Cache-Control", "If-None-Match", "X-Forwarded-For", "X-Request-Id" };
+    std::vector<std::string> const input = { "host", "user-agent", "ACCEPT", "accept-encoding",
+        "Accept-Language", "connection", "cookie", "x-forwarded-for", "X-Custom-Header",
+        "content-type", "If-Modified-Since", "x-request-id" };
+    size_t const n = 1<<18;
+    size_t sum = 0;
+
+    double t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+            for(std::string const & in : input)
+                for(std::string const & k : known)
+                    if(str_ref_cmp_eq_ci(str_ref(in.data(), in.size()), str_ref(k.data(), k.size())))
+                    {
+                        ++sum;
+                        break;
+                    }
+    });
+    bench_report("str_ref_cmp_eq_ci", t, n*input.size(), 0);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+            for(std::string const & in : input)
+                for(std::string const & k : known)
+                    if((in.size() == k.size()) && (strncasecmp(in.data(), k.data(), in.size()) == 0))
+                    {
+                        ++sum;
+                        break;
+                    }
+    });
+    bench_report("length + strncasecmp", t, n*input.size(), 0);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+            for(std::string const & in : input)
+                for(std::string const & k : known)
+                    if(strcasecmp(in.c_str(), k.c_str()) == 0)
+                    {
+                        ++sum;
+                        break;
+                    }
+    });
+    bench_report("strcasecmp", t, n*input.size(), 0);
+
+    // names equal up to case, the whole name is compared
+    std::vector<std::string> upper = known;
+    for(std::string & k : upper)
+        for(char & c : k)
+            c = str_ascii_toupper(c);
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i, bench_keep(i)) // no hoisting of pure calls
+            for(size_t j = 0; j < known.size(); ++j)
+                sum += str_ref_cmp_eq_ci(str_ref(known[j].data(), known[j].size()),
+                    str_ref(upper[j].data(), upper[j].size()));
+    });
+    bench_report("equal names, str_ref_cmp_eq_ci", t, n*known.size(), 0);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i, bench_keep(i))
+            for(size_t j = 0; j < known.size(); ++j)
+                sum += strncasecmp(known[j].data(), upper[j].data(), known[j].size()) == 0;
+    });
+    bench_report("equal names, strncasecmp", t, n*known.size(), 0);
+
+    // sorting by name
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+            for(std::string const & in : input)
+                for(std::string const & k : known)
+                    sum += str_ref_cmp_ci(str_ref(in.data(), in.size()), str_ref(k.data(), k.size())) < 0;
+    });
+    bench_report("str_ref_cmp_ci", t, n*input.size()*known.size(), 0);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+            for(std::string const & in : input)
+                for(std::string const & k : known)
+                    sum += strcasecmp(in.c_str(), k.c_str()) < 0;
+    });
+    bench_report("strcasecmp", t, n*input.size()*known.size(), 0);
+    bench_keep(sum);
+}
@@ -0,0 +1,102 @@
+#include <str/ref.h>
+
+#include "bench.h"
+
+#include <cstring>
+#include <string>
+
+BENCH("str_ref_find")
+{
+    // HTTP-like text, "\r\n" on every line, the header end is the last line
+    std::string text;
+    unsigned x = 1;
+    while(text.size() < size_t(100)<<20)
+    {
+        x = x*1103515245u + 12345u;
+        text.append("X-Header-").append(std::to_string(x)).append(": some value\r\n");
+    }
+    StrRef const sub = str_ref_cstr("\r\n\r\n");
+
+    for(size_t size : { size_t(1)<<10, size_t(1)<<16, size_t(1)<<20, size_t(100)<<20 })
+    {
+        std::string hay = text.substr(0, size - 4) + "\r\n\r\n";
+        size_t const n = (size_t(1)<<30)/size;
+        char what[64];
+        size_t sum = 0;
+
+        double t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+                sum += str_ref_find(str_ref(hay.data(), hay.size()), sub);
+        });
+        std::snprintf(what, sizeof(what), "%6zukB, str_ref_find", size>>10);
+        bench_report(what, t, n, double(size)*n);
+
+        t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+                sum += (char const *)memmem(hay.data(), hay.size(), sub.ptr, sub.len) - hay.data();
+        });
+        std::snprintf(what, sizeof(what), "%6zukB, memmem", size>>10);
+        bench_report(what, t, n, double(size)*n);
+
+        t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+                sum += hay.find("\r\n\r\n");
+        });
+        std::snprintf(what, sizeof(what), "%6zukB, std::string::find", size>>10);
+        bench_report(what, t, n, double(size)*n);
+
+        // boundary at the beginning, searched from the end
+        hay.replace(0, 4, "\r\n\r\n");
+        hay.replace(hay.size() - 4, 4, "abcd");
+        t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+                sum += str_ref_rfind(str_ref(hay.data(), hay.size()), sub);
+        });
+        std::snprintf(what, sizeof(what), "%6zukB, str_ref_rfind", size>>10);
+        bench_report(what, t, n, double(size)*n);
+
+        t = bench_time([&]
+        {
+            for(size_t i = 0; i < n; ++i)
+                sum += hay.rfind("\r\n\r\n");
+        });
+        std::snprintf(what, sizeof(what), "%6zukB, std::string::rfind", size>>10);
+        bench_report(what, t, n, double(size)*n);
+        bench_keep(sum);
+    }
+}
+
+BENCH("str_ref_find short")
+{
+    // headers of one small request, AVX2 loop runs once, the rest is the SSE2 tail
+    std::string const hay = "GET / HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\n\r\n";
+    StrRef const sub = str_ref_cstr("\r\n\r\n");
+    size_t const n = size_t(1)<<24;
+    size_t sum = 0;
+
+    double t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i, bench_keep(i)) // no hoisting of pure calls
+            sum += str_ref_find(str_ref(hay.data(), hay.size()), sub);
+    });
+    bench_report("str_ref_find", t, n, double(hay.size())*n);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i, bench_keep(i))
+            sum += str_ref_rfind(str_ref(hay.data(), hay.size()), sub);
+    });
+    bench_report("str_ref_rfind", t, n, double(hay.size())*n);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i, bench_keep(i))
+            sum += (char const *)memmem(hay.data(), hay.size(), sub.ptr, sub.len) - hay.data();
+    });
+    bench_report("memmem", t, n, double(hay.size())*n);
+    bench_keep(sum);
+}
@@ -0,0 +1,44 @@
+#include <str/ref_hash.h>
+
+#include "bench.h"
+
+#include <cstdint>
+#include <string>
+
+static uint64_t bench_fnv1a(StrRef ref)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for(size_t i = 0; i < ref.len; ++i)
+        hash = (hash ^ (unsigned char)ref.ptr[i]) * 0x100000001b3ull;
+    return hash;
+}
+
+BENCH("str_ref_hash lengths")
+{
+    std::string const buf(size_t(1)<<20, 'K');
+    for(size_t len = 1; len <= buf.size(); len *= 4)
+    {
+        // 64MB hashed per measurement, at most 4M calls
+        size_t const n = len < 16 ? size_t(1)<<22 : (size_t(1)<<26)/len;
+        StrRef const ref = str_ref(buf.data(), len);
+        auto run = [&](char const * name, uint64_t (*fun)(StrRef))
+        {
+            uint64_t sum = 0;
+            double const t = bench_time([&]
+            {
+                for(size_t i = 0; i < n; ++i)
+                {
+                    sum += fun(ref);
+                    bench_keep(sum);
+                }
+            });
+            char what[64];
+            std::snprintf(what, sizeof(what), "%7zuB, %s", len, name);
+            bench_report(what, t, n, double(len)*n);
+        };
+        run("wyhash", [](StrRef r) { return str_ref_hash(r, 0); });
+        run("wyhash ci", [](StrRef r) { return str_ref_hash_ci(r, 0); });
+        if(len <= (size_t(1)<<16))
+            run("fnv1a", bench_fnv1a);
+    }
+}
@@ -0,0 +1,78 @@
+#include <str/ref.h>
+
+#include "bench.h"
+
+#include <string>
+
+BENCH("str_ref_split_c")
+{
+    // log file, lines of 20 to 120 bytes
+    std::string text;
+    unsigned x = 1;
+    while(text.size() < size_t(64)<<20)
+    {
+        x = x*1103515245u + 12345u;
+        text.append(20 + (x>>16) % 100, 'l').push_back('\n');
+    }
+    size_t const n = 8;
+    double const bytes = double(text.size())*n;
+    size_t sum = 0;
+
+    double t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+        {
+            StrRef ref = str_ref(text.data(), text.size());
+            StrRef lines[256];
+            for(size_t cnt; (cnt = str_ref_split_c(&ref, '\n', lines, 256)); )
+                for(size_t j = 0; j < cnt; ++j)
+                    sum += lines[j].len;
+        }
+    });
+    bench_report("str_ref_split_c", t, n, bytes);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+        {
+            StrRef ref = str_ref(text.data(), text.size());
+            while(!str_ref_is_empty(ref))
+                sum += str_ref_word_c(&ref, '\n').len;
+        }
+    });
+    bench_report("str_ref_word_c", t, n, bytes);
+    bench_keep(sum);
+}
+
+BENCH("str_ref_split_c short")
+{
+    // one CSV record, AVX2 loop runs once, the rest is the SSE2 tail
+    std::string const text = "17,2024-01-01,worker-17,GET,/api/v1/items/42,200,ok,12ms,curl/8.5.0,10.0.0.1";
+    size_t const n = size_t(1)<<24;
+    size_t sum = 0;
+
+    double t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+        {
+            StrRef ref = str_ref(text.data(), text.size());
+            StrRef fields[16];
+            for(size_t cnt; (cnt = str_ref_split_c(&ref, ',', fields, 16)); )
+                for(size_t j = 0; j < cnt; ++j)
+                    sum += fields[j].len;
+        }
+    });
+    bench_report("str_ref_split_c", t, n, double(text.size())*n);
+
+    t = bench_time([&]
+    {
+        for(size_t i = 0; i < n; ++i)
+        {
+            StrRef ref = str_ref(text.data(), text.size());
+            while(!str_ref_is_empty(ref))
+                sum += str_ref_word_c(&ref, ',').len;
+        }
+    });
+    bench_report("str_ref_word_c", t, n, double(text.size())*n);
+    bench_keep(sum);
+}
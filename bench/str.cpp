@@ -0,0 +1,378 @@
+#include <str/alloc.h>
+#include <str/str.h>
+
+#include "bench.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+static double bench_append(unsigned growth, int n)
+{
+    unsigned const old = str_str_set_growth(growth);
+    double const t = bench_time([&]
+    {
+        StrStr str;
+        str_str_init_empty(&str);
+        for(int i = 0; i < n; ++i)
+            str_str_cat(&str, str_ref("abcdefgh", 8));
+        bench_keep(str);
+        str_str_kill(&str);
+    });
+    str_str_set_growth(old);
+    return t;
+}
+
+BENCH("str_str_cat growth")
+{
+    // exact growth is quadratic, don't wait for hours
+    for(int n : { 1000, 10000, 30000 })
+    {
+        char what[64];
+        std::snprintf(what, sizeof(what), "%7d x 8B, exact", n);
+        bench_report(what, bench_append(100, n), n);
+    }
+    for(int n : { 1000, 10000, 100000, 1000000 })
+    {
+        char what[64];
+        std::snprintf(what, sizeof(what), "%7d x 8B, 1.5x", n);
+        bench_report(what, bench_append(150, n), n);
+        std::snprintf(what, sizeof(what), "%7d x 8B, 2x", n);
+        bench_report(what, bench_append(200, n), n);
+    }
+}
+
+BENCH("str_str_cat large buffer")
+{
+    // log/blob buffer built from 64kB chunks
+    static size_t const CHUNK = 1<<16;
+    static char chunk[CHUNK];
+    std::memset(chunk, 'x', CHUNK);
+    for(size_t total : { size_t(1)<<24, size_t(1)<<26, size_t(1)<<28 })
+    {
+        size_t const n = total/CHUNK;
+        char what[64];
+
+        // growth by malloc+memcpy+free, same policy as str_str_grow
+        size_t copied = 0;
+        double t = bench_time([&]
+        {
+            char * ptr = nullptr;
+            size_t len = 0, cap = 0;
+            for(size_t i = 0; i < n; ++i)
+            {
+                if(len + CHUNK > cap)
+                {
+                    cap = cap*2 < len + CHUNK ? len + CHUNK : cap*2;
+                    char * tmp = static_cast<char*>(std::malloc(cap+1));
+                    std::memcpy(tmp, ptr, len);
+                    copied += len;
+                    std::free(ptr);
+                    ptr = tmp;
+                }
+                std::memcpy(ptr+len, chunk, CHUNK);
+                len += CHUNK;
+            }
+            bench_keep(ptr);
+            std::free(ptr);
+        });
+        std::snprintf(what, sizeof(what), "%4zuMB malloc+copy (%zuMB copied)", total>>20, copied>>20);
+        bench_report(what, t, n, total);
+
+        // str_str_cat grows long strings by realloc
+        size_t moved = 0;
+        t = bench_time([&]
+        {
+            StrStr str;
+            str_str_init_empty(&str);
+            for(size_t i = 0; i < n; ++i)
+            {
+                char const * old = str_str_ptr(&str);
+                int const len = str_str_len(&str);
+                str_str_cat(&str, str_ref(chunk, CHUNK));
+                if(old != str_str_ptr(&str))
+                    moved += len;
+            }
+            bench_keep(str);
+            str_str_kill(&str);
+        });
+        std::snprintf(what, sizeof(what), "%4zuMB realloc (%zuMB moved)", total>>20, moved>>20);
+        bench_report(what, t, n, total);
+    }
+}
+
+BENCH("str_str_catv url")
+{
+    int const N = 1000000;
+    StrRef const scheme = str_ref_cstr("https"), host = str_ref_cstr("api.example.com"),
+        path = str_ref_cstr("/v1/resources/1234567890/items"), query = str_ref_cstr("page=2&limit=100");
+    StrRef const sep = str_ref_cstr("://"), qm = str_ref_cstr("?");
+
+    double t = bench_time([&]
+    {
+        for(int i = 0; i < N; ++i)
+        {
+            StrStr url;
+            str_str_init_empty(&url);
+            str_str_cat(&url, scheme);
+            str_str_cat(&url, sep);
+            str_str_cat(&url, host);
+            str_str_cat(&url, path);
+            str_str_cat(&url, qm);
+            str_str_cat(&url, query);
+            bench_keep(url);
+            str_str_kill(&url);
+        }
+    });
+    bench_report("6x str_str_cat", t, N);
+
+    t = bench_time([&]
+    {
+        for(int i = 0; i < N; ++i)
+        {
+            StrStr url;
+            str_str_init_empty(&url);
+            str_str_catv(&url, scheme, sep, host, path, qm, query);
+            bench_keep(url);
+            str_str_kill(&url);
+        }
+    });
+    bench_report("str_str_catv", t, N);
+}
+
+BENCH("str_str_fmt log line")
+{
+    int const N = 200000;
+    std::string const msg(2000, 'm');
+    char const * const FMT = "%s %s:%d [%s] %08x %s user=%s path=%s took=%.3fms\n";
+    auto line = [&](bool (*fmt)(StrStr *, char const *, ...), StrStr * str)
+    {
+        fmt(str, FMT, "2024-01-01T00:00:00Z", "server.c", 1234, "INFO",
+            0xdeadbeef, msg.c_str(), "someone", "/v1/some/long/path", 12.345);
+    };
+
+    for(auto f : { std::make_pair("two-pass, new string", str_str_fmt),
+        std::make_pair("one-pass, new string", str_str_fmt_stream) })
+    {
+        double const t = bench_time([&]
+        {
+            for(int i = 0; i < N; ++i)
+            {
+                StrStr str;
+                str_str_init_empty(&str);
+                line(f.second, &str);
+                bench_keep(str);
+                str_str_kill(&str);
+            }
+        });
+        bench_report(f.first, t, N);
+    }
+
+    for(auto f : { std::make_pair("two-pass, reused string", str_str_fmt),
+        std::make_pair("one-pass, reused string", str_str_fmt_stream) })
+    {
+        StrStr str;
+        str_str_init_empty(&str);
+        double const t = bench_time([&]
+        {
+            for(int i = 0; i < N; ++i)
+            {
+                line(f.second, &str);
+                bench_keep(str);
+            }
+        });
+        str_str_kill(&str);
+        bench_report(f.first, t, N);
+    }
+}
+
+static size_t bench_allocs;
+
+static void * bench_count_alloc(void *, size_t size)
+{
+    ++bench_allocs;
+    return std::malloc(size);
+}
+
+static void * bench_count_realloc(void *, void * ptr, size_t, size_t size)
+{
+    ++bench_allocs;
+    return std::realloc(ptr, size);
+}
+
+static void bench_count_free(void *, void * ptr, size_t)
+{
+    std::free(ptr);
+}
+
+// malloc counting calls in bench_allocs
+static StrAlloc const bench_count = { bench_count_alloc, bench_count_realloc, bench_count_free, nullptr };
+
+BENCH("str_str_cstr mapped records")
+{
+    // NUL-separated records, like a strings table of a mapped file
+    static int const N = 1000000;
+    std::string data;
+    for(int i = 0; i < N; ++i)
+    {
+        char rec[64];
+        data.append(rec, std::snprintf(rec, sizeof(rec), "/usr/share/record/%08d.dat", i));
+        data.push_back('\0');
+    }
+
+    char path[] = "/tmp/libstr-bench-XXXXXX";
+    int const fd = mkstemp(path);
+    if(fd < 0 || write(fd, data.data(), data.size()) != ssize_t(data.size()))
+        return;
+    void * const map = mmap(nullptr, data.size(), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    unlink(path);
+    if(map == MAP_FAILED)
+        return;
+
+    StrAlloc const * old = str_alloc_set_thread(&bench_count);
+
+    auto walk = [&](void (*init)(StrStr *, StrRef))
+    {
+        size_t sum = 0;
+        char const * ptr = static_cast<char const *>(map);
+        char const * const end = ptr + data.size();
+        while(ptr < end)
+        {
+            size_t const len = std::strlen(ptr);
+            StrStr str;
+            init(&str, str_ref(ptr, len));
+            sum += std::strlen(str_str_cstr(&str));
+            str_str_kill(&str);
+            ptr += len + 1;
+        }
+        bench_keep(sum);
+    };
+
+    for(auto f : { std::make_pair("const, cstr", str_str_init_const),
+        std::make_pair("const rterm, cstr", str_str_init_const_rterm) })
+    {
+        bench_allocs = 0;
+        double const t = bench_time([&]{ walk(f.second); });
+        char what[64];
+        std::snprintf(what, sizeof(what), "%s (%zu allocs)", f.first, bench_allocs);
+        bench_report(what, t, N, data.size());
+    }
+
+    str_alloc_set_thread(old);
+    munmap(map, data.size());
+}
+
+BENCH("str_str_cstr repeated")
+{
+    // the same long string handed to C APIs again and again
+    static int const N = 1000000;
+    for(size_t len : { size_t(64), size_t(4096), size_t(65536) })
+    {
+        std::string const src(len, 'x');
+        StrStr str;
+        str_str_init_empty(&str);
+        str_str_cat(&str, str_ref(src.data(), src.size()));
+
+        size_t sum = 0;
+        double const t = bench_time([&]
+        {
+            for(int i = 0; i < N; ++i)
+                sum += reinterpret_cast<uintptr_t>(str_str_cstr(&str));
+        });
+        bench_keep(sum);
+
+        // what every call cost before the result was cached
+        double const u = bench_time([&]
+        {
+            for(int i = 0; i < N; ++i)
+            {
+                char const * ptr = str_str_ptr(&str);
+                sum += std::memchr(ptr, '\0', len) ? 0 : 1;
+                bench_keep(sum);
+            }
+        });
+        str_str_kill(&str);
+
+        char what[64];
+        std::snprintf(what, sizeof(what), "%6zuB, cached", len);
+        bench_report(what, t, N);
+        std::snprintf(what, sizeof(what), "%6zuB, scan", len);
+        bench_report(what, u, N, double(len)*N);
+    }
+}
+
+BENCH("str_str key lengths")
+{
+    // keys of a typical service map: ids, timestamps, addresses, UUIDs
+    static int const N = 1000000;
+    std::vector<std::string> keys;
+    keys.reserve(N);
+    for(int i = 0; i < N; ++i)
+    {
+        char key[64];
+        int len = 0;
+        switch(i % 8)
+        {
+            case 0 : // short id
+                len = std::snprintf(key, sizeof(key), "u%d", i);
+                break;
+            case 1 : // IPv4
+                len = std::snprintf(key, sizeof(key), "10.%d.%d.%d", i>>16&255, i>>8&255, i&255);
+                break;
+            case 2 : // ISO timestamp
+            case 3 :
+                len = std::snprintf(key, sizeof(key), "2024-01-%02dT%02d:%02d:%02dZ",
+                    1 + i%28, i/3600%24, i/60%60, i%60);
+                break;
+            case 4 : // IPv6
+                len = std::snprintf(key, sizeof(key), "2001:db8:%x:%x::%x", i>>16, i&0xffff, i%251);
+                break;
+            case 5 : // UUID without dashes
+                len = std::snprintf(key, sizeof(key), "%08x%08x%08x%08x",
+                    i*2654435761u, i, ~i, i*40503u);
+                break;
+            case 6 : // UUID
+                len = std::snprintf(key, sizeof(key), "%08x-%04x-4%03x-8%03x-%012x",
+                    i*2654435761u, i&0xffff, i&0xfff, (i>>12)&0xfff, i);
+                break;
+            default : // path
+                len = std::snprintf(key, sizeof(key), "/api/v2/items/%d/details", i);
+                break;
+        }
+        keys.emplace_back(key, len);
+    }
+
+    // what other layouts would allocate
+    for(size_t cap : { size_t(15), size_t(23), size_t(31) })
+    {
+        size_t spill = 0;
+        for(auto const & key : keys)
+            spill += key.size() > cap;
+        std::printf("  %2zu characters inline: %4.1f%% keys allocate\n",
+            cap, 100.0*spill/N);
+    }
+
+    StrAlloc const * old = str_alloc_set_thread(&bench_count);
+    std::vector<StrStr> strs(N);
+    bench_allocs = 0;
+    double const t = bench_time([&]
+    {
+        for(int i = 0; i < N; ++i)
+            str_str_init_copy(&strs[i], str_ref(keys[i].data(), keys[i].size()));
+        for(int i = 0; i < N; ++i)
+            str_str_kill(&strs[i]);
+    });
+    str_alloc_set_thread(old);
+
+    char what[64];
+    std::snprintf(what, sizeof(what), "copy+kill, %zuB StrStr (%zu allocs)",
+        sizeof(StrStr), bench_allocs);
+    bench_report(what, t, N);
+}
@@ -0,0 +1,142 @@
+#include <str/str.h>
+
+#include "catch.hpp"
+
+namespace {
+
+struct Counter
+{
+    size_t allocs = 0, frees = 0, bytes = 0;
+};
+
+void * counting_alloc(void * ctx, size_t size)
+{
+    Counter * c = static_cast<Counter*>(ctx);
+    ++c->allocs;
+    c->bytes += size;
+    return malloc(size);
+}
+
+void counting_free(void * ctx, void * ptr, size_t size)
+{
+    Counter * c = static_cast<Counter*>(ctx);
+    ++c->frees;
+    c->bytes -= size;
+    free(ptr);
+}
+
+}
+
+TEST_CASE("StrAlloc selection", "[alloc]")
+{
+    CHECK(str_alloc_get() == str_alloc_default());
+
+    Counter cnt;
+    StrAlloc const a = { counting_alloc, nullptr, counting_free, &cnt };
+
+    GIVEN("thread allocator")
+    {
+        CHECK(str_alloc_set_thread(&a) == nullptr);
+        CHECK(str_alloc_get() == &a);
+        CHECK(str_alloc_set_thread(nullptr) == &a);
+        CHECK(str_alloc_get() == str_alloc_default());
+    }
+
+    GIVEN("global allocator")
+    {
+        CHECK(str_alloc_set_global(&a) == nullptr);
+        CHECK(str_alloc_get() == &a);
+        WHEN("thread allocator is set")
+        {
+            StrAlloc const b = a;
+            str_alloc_set_thread(&b);
+            THEN("it overrides global")
+                CHECK(str_alloc_get() == &b);
+            str_alloc_set_thread(nullptr);
+        }
+        CHECK(str_alloc_set_global(nullptr) == &a);
+    }
+}
+
+TEST_CASE("StrStr with custom allocator", "[alloc]")
+{
+    Counter cnt;
+    StrAlloc const a = { counting_alloc, nullptr, counting_free, &cnt };
+    std::string ref(100, 'x');
+
+    GIVEN("string allocated by thread allocator")
+    {
+        StrStr str;
+        str_str_init_empty(&str);
+
+        StrAlloc const * old = str_alloc_set_thread(&a);
+        REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+        REQUIRE(str_str_fmt(&str, "%s%s", ref.c_str(), ref.c_str()));
+        str_alloc_set_thread(old);
+
+        CHECK(cnt.allocs > 0);
+        CHECK(std::string(ref+ref) == str_str_ptr(&str));
+
+        WHEN("grown after the allocator was reset")
+        {
+            size_t const allocs = cnt.allocs;
+            for(int i = 0; i < 100; ++i)
+                REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+            THEN("string keeps its allocator")
+                CHECK(cnt.allocs > allocs);
+        }
+
+        WHEN("converted to cstr first")
+        {
+            REQUIRE(str_str_cstr(&str) == str_str_ptr(&str));
+            THEN("it still grows by its allocator")
+            {
+                size_t const allocs = cnt.allocs;
+                REQUIRE(str_str_alloc(&str, 100000, INT_MAX));
+                CHECK(cnt.allocs > allocs);
+                CHECK(std::string(ref+ref) == str_str_ptr(&str));
+            }
+        }
+
+        WHEN("shrunk after the allocator was reset")
+        {
+            REQUIRE(str_str_reserve(&str, 10000));
+            REQUIRE(str_str_shrink_to_fit(&str));
+            THEN("its allocator is used")
+            {
+                CHECK(str_str_cap(&str) == 200);
+                CHECK(cnt.bytes > 200);
+                CHECK(cnt.bytes < 10000);
+            }
+        }
+
+        WHEN("killed after the allocator was reset")
+        {
+            str_str_kill(&str);
+            str_str_init_null(&str);
+            THEN("memory is returned to it")
+            {
+                CHECK(cnt.allocs == cnt.frees);
+                CHECK(cnt.bytes == 0);
+            }
+        }
+
+        str_str_kill(&str);
+        CHECK(cnt.allocs == cnt.frees);
+        CHECK(cnt.bytes == 0);
+    }
+
+    GIVEN("string allocated with explicit allocator")
+    {
+        StrStr str;
+        str_str_init_empty(&str);
+        REQUIRE(str_str_alloc_with(&str, &a, 1000, 0));
+        CHECK(cnt.allocs == 1);
+        CHECK(str_str_cap(&str) == 1000);
+        REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+        CHECK(ref == str_str_ptr(&str));
+        str_str_kill(&str);
+        CHECK(cnt.frees == 1);
+        CHECK(cnt.bytes == 0);
+    }
+}
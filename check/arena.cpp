@@ -0,0 +1,120 @@
+#include <str/arena.h>
+#include <str/str.h>
+
+#include "catch.hpp"
+
+TEST_CASE("StrArena allocation", "[arena]")
+{
+    StrArena arena;
+    str_arena_init(&arena, 256);
+    CHECK(str_arena_size(&arena) == 0);
+
+    GIVEN("small allocations")
+    {
+        char * a = static_cast<char*>(str_arena_alloc(&arena, 10));
+        char * b = static_cast<char*>(str_arena_alloc(&arena, 10));
+        REQUIRE(a);
+        REQUIRE(b);
+        THEN("they are bumped from one chunk")
+        {
+            // void pointers, Catch would print char pointers as strings
+            CHECK(static_cast<void const*>(b) > static_cast<void const*>(a));
+            CHECK(b - a < 32);
+            CHECK(reinterpret_cast<uintptr_t>(b) % sizeof(void*) == 0);
+        }
+
+        WHEN("rewound to a mark")
+        {
+            StrArenaMark mark = str_arena_mark(&arena);
+            char * c = static_cast<char*>(str_arena_alloc(&arena, 1000));
+            REQUIRE(c);
+            size_t const size = str_arena_size(&arena);
+            str_arena_rewind(&arena, mark);
+            THEN("memory after the mark is reused")
+            {
+                CHECK(str_arena_size(&arena) < size);
+                CHECK(str_arena_alloc(&arena, 10) == static_cast<void const*>(b + (b - a)));
+            }
+        }
+
+        WHEN("reset")
+        {
+            for(int i = 0; i < 100; ++i)
+                str_arena_alloc(&arena, 100);
+            str_arena_reset(&arena);
+            THEN("only the first chunk is kept")
+            {
+                CHECK(str_arena_size(&arena) > 0);
+                CHECK(str_arena_size(&arena) < 512);
+                CHECK(str_arena_alloc(&arena, 10) == static_cast<void const*>(a));
+            }
+        }
+    }
+
+    str_arena_kill(&arena);
+    CHECK(str_arena_size(&arena) == 0);
+}
+
+TEST_CASE("StrStr in arena", "[arena]")
+{
+    StrArena arena;
+    str_arena_init(&arena, 0);
+    std::string ref(100, 'x');
+
+    StrAlloc const * old = str_alloc_set_thread(str_arena_allocator(&arena));
+
+    GIVEN("long string")
+    {
+        StrStr str;
+        str_str_init_empty(&str);
+        REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+
+        THEN("it is weak")
+        {
+            CHECK(str_str_get_tag(&str) == STR_TAG_REF);
+            CHECK(str_str_is_mutable(&str));
+            CHECK(ref == str_str_ptr(&str));
+        }
+
+        WHEN("appended")
+        {
+            char const * ptr = str_str_ptr(&str);
+            for(int i = 0; i < 10; ++i)
+                REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+            THEN("last block is extended in place")
+            {
+                CHECK(str_str_ptr(&str) == ptr);
+                CHECK(str_str_len(&str) == 1100);
+            }
+        }
+
+        WHEN("formatted")
+        {
+            REQUIRE(str_str_fmt(&str, "%s%s", ref.c_str(), ref.c_str()));
+            CHECK(ref+ref == str_str_ptr(&str));
+        }
+
+        str_str_kill(&str);
+    }
+
+    GIVEN("string allocated on heap before")
+    {
+        str_alloc_set_thread(old);
+        StrStr str;
+        str_str_init_empty(&str);
+        REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+        str_alloc_set_thread(str_arena_allocator(&arena));
+
+        WHEN("grown")
+        {
+            REQUIRE(str_str_alloc(&str, 1000, INT_MAX));
+            THEN("it stays on heap")
+                CHECK(str_str_get_tag(&str) == STR_TAG_STR);
+        }
+
+        str_str_kill(&str);
+    }
+
+    str_alloc_set_thread(old);
+    str_arena_kill(&arena);
+}
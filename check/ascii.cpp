@@ -0,0 +1,93 @@
+#include <str/ascii.h>
+#include <str/ref.h>
+
+#include "catch.hpp"
+
+#include <cctype>
+#include <string>
+
+TEST_CASE("StrAscii", "[ascii]")
+{
+    GIVEN("all bytes")
+    {
+        THEN("classes match <cctype> in the C locale")
+        {
+            for(int i = 0; i < 256; ++i)
+            {
+                char const c = char(i);
+                bool const ascii = i < 0x80;
+                CHECK(str_ascii_is_space(c) == (ascii && std::isspace(i)));
+                CHECK(str_ascii_is_digit(c) == (ascii && std::isdigit(i)));
+                CHECK(str_ascii_is_alpha(c) == (ascii && std::isalpha(i)));
+                CHECK(str_ascii_is_alnum(c) == (ascii && std::isalnum(i)));
+                CHECK(str_ascii_is_xdigit(c) == (ascii && std::isxdigit(i)));
+                CHECK(str_ascii_is(c, STR_ASCII_UPPER) == (ascii && std::isupper(i)));
+                CHECK(str_ascii_is(c, STR_ASCII_LOWER) == (ascii && std::islower(i)));
+                CHECK(str_ascii_is(c, STR_ASCII_PUNCT) == (ascii && std::ispunct(i)));
+                CHECK(str_ascii_is(c, STR_ASCII_CNTRL) == (ascii && std::iscntrl(i)));
+                CHECK(str_ascii_tolower(c) == (ascii ? char(std::tolower(i)) : c));
+                CHECK(str_ascii_toupper(c) == (ascii ? char(std::toupper(i)) : c));
+            }
+        }
+    }
+
+    GIVEN("buffers of all bytes")
+    {
+        std::string src;
+        for(int i = 0; i < 3*256; ++i)
+            src.push_back(char(i*11));
+        THEN("bulk conversion matches per byte conversion for all lengths and offsets")
+        {
+            for(size_t beg = 0; beg < 70; beg += 3)
+                for(size_t len = 0; beg + len <= src.size(); len += (len < 200 ? 1 : 37))
+                {
+                    std::string lower(len, '\0'), upper(len, '\0');
+                    str_ascii_tolower_n(&lower[0], src.data() + beg, len);
+                    str_ascii_toupper_n(&upper[0], src.data() + beg, len);
+                    bool ok = true;
+                    for(size_t i = 0; i < len; ++i)
+                        ok = ok && (lower[i] == str_ascii_tolower(src[beg+i]))
+                            && (upper[i] == str_ascii_toupper(src[beg+i]));
+                    CHECK(ok);
+                }
+        }
+        THEN("conversion works in place")
+        {
+            std::string buf = src;
+            str_ascii_toupper_n(&buf[0], buf.data(), buf.size());
+            str_ascii_tolower_n(&buf[0], buf.data(), buf.size());
+            for(size_t i = 0; i < src.size(); ++i)
+                CHECK(buf[i] == str_ascii_tolower(src[i]));
+        }
+    }
+
+    GIVEN("space padded strings")
+    {
+        CHECK(str_ref_is_null(str_ref_trim_spaces(str_ref_null())));
+        CHECK(str_ref_trim_spaces(str_ref_cstr(" \t\r\n\v\f")).len == 0);
+
+        char const spaces[] = " \t\n\v\f\r";
+        THEN("trimming matches a byte loop for all pad lengths")
+        {
+            for(size_t pre = 0; pre < 70; ++pre)
+                for(size_t post = 0; post < 70; post += (post < 40 ? 1 : 7))
+                    for(char const * word : { "", "x", "a b", "\xa0" })
+                    {
+                        std::string s;
+                        for(size_t i = 0; i < pre; ++i)
+                            s.push_back(spaces[i % 6]);
+                        s += word;
+                        for(size_t i = 0; i < post; ++i)
+                            s.push_back(spaces[(i*5) % 6]);
+                        StrRef const ref = str_ref(s.data(), s.size());
+                        size_t const beg = std::string(word).empty() ? s.size() : pre;
+                        StrRef const trim = str_ref_trim_spaces(ref);
+                        CHECK(trim.ptr == s.data() + beg);
+                        CHECK(std::string(trim.ptr, trim.len) == word);
+                        StrRef const chop = str_ref_chop_spaces(ref);
+                        CHECK(chop.ptr == s.data());
+                        CHECK(chop.len == (std::string(word).empty() ? 0 : pre + std::string(word).size()));
+                    }
+        }
+    }
+}
@@ -0,0 +1,152 @@
+#include <str/big.h>
+#include <str/str.h>
+
+#include "catch.hpp"
+
+#include <string>
+
+TEST_CASE("StrBig construction", "[big]")
+{
+    GIVEN("null string")
+    {
+        StrBig big;
+        str_big_init_null(&big);
+        CHECK(str_big_is_null(&big));
+        CHECK(str_big_is_empty(&big));
+        CHECK(*str_big_ptr(&big) == '\0');
+        THEN("cstr gives empty string")
+            CHECK(std::string() == str_big_cstr(&big));
+        str_big_kill(&big);
+    }
+
+    GIVEN("short copy")
+    {
+        std::string const ref(STR_BIG_SSO_CAP, 'x');
+        StrBig big;
+        REQUIRE(str_big_init_copy(&big, str_ref(ref.data(), ref.size())));
+        THEN("contents are stored inside")
+        {
+            CHECK(str_big_len(&big) == ref.size());
+            CHECK(str_big_cap(&big) == STR_BIG_SSO_CAP);
+            CHECK((void*)str_big_ptr(&big) == (void*)&big);
+            CHECK(ref == str_big_ptr(&big));
+        }
+        str_big_kill(&big);
+    }
+
+    GIVEN("long copy")
+    {
+        std::string const ref(1000, 'x');
+        StrBig big;
+        REQUIRE(str_big_init_copy(&big, str_ref(ref.data(), ref.size())));
+        CHECK(str_big_len(&big) == ref.size());
+        CHECK(str_big_cap(&big) == ref.size());
+        CHECK(ref == str_big_cstr(&big));
+
+        WHEN("moved")
+        {
+            StrBig dst;
+            str_big_init_move(&dst, &big);
+            THEN("source is null")
+            {
+                CHECK(str_big_is_null(&big));
+                CHECK(ref == str_big_ptr(&dst));
+            }
+            str_big_kill(&dst);
+        }
+
+        str_big_kill(&big);
+    }
+
+    GIVEN("const reference longer than INT_MAX")
+    {
+        // length is not checked against memory, nothing is read
+        static char const buf[] = "payload";
+        size_t const len = (size_t)INT_MAX + 1000;
+        StrBig big;
+        str_big_init_const(&big, str_ref(buf, len));
+        THEN("length is kept")
+        {
+            CHECK(!str_big_is_null(&big));
+            CHECK(!str_big_is_mutable(&big));
+            CHECK(str_big_len(&big) == len);
+            CHECK(str_big_ref(&big).len == len);
+            CHECK(str_big_ptr(&big) == buf);
+        }
+        str_big_kill(&big);
+    }
+}
+
+TEST_CASE("StrBig append", "[big]")
+{
+    GIVEN("empty string")
+    {
+        StrBig big;
+        str_big_init_empty(&big);
+        std::string ref;
+
+        WHEN("appended to many times")
+        {
+            for(int i = 0; i < 1000; ++i)
+            {
+                REQUIRE(str_big_cat(&big, str_ref("abcdefgh", 8)));
+                ref.append("abcdefgh");
+            }
+            THEN("contents match and capacity grows geometrically")
+            {
+                CHECK(ref == str_big_ptr(&big));
+                CHECK(str_big_len(&big) == ref.size());
+                CHECK(str_big_cap(&big) < 2*ref.size());
+            }
+        }
+
+        WHEN("exact growth is set")
+        {
+            unsigned const old = str_str_set_growth(100);
+            for(int i = 0; i < 100; ++i)
+                REQUIRE(str_big_cat(&big, str_ref("abcdefgh", 8)));
+            CHECK(str_big_cap(&big) == 800);
+            CHECK(str_str_set_growth(old) == 100);
+        }
+
+        str_big_kill(&big);
+    }
+
+    GIVEN("const string")
+    {
+        char buf[] = "const-string-longer-than-inline";
+        StrBig big;
+        str_big_init_const(&big, str_ref(buf, 5));
+
+        WHEN("appended to")
+        {
+            REQUIRE(str_big_cat(&big, str_ref("-tail", 5)));
+            THEN("contents are copied")
+            {
+                CHECK(str_big_is_mutable(&big));
+                CHECK(std::string("const-tail") == str_big_ptr(&big));
+                CHECK(std::string("const-string-longer-than-inline") == buf);
+            }
+        }
+
+        WHEN("converted to cstr")
+        {
+            char const * ptr = str_big_cstr(&big);
+            THEN("terminator is not read from the buffer")
+            {
+                CHECK(ptr != buf);
+                CHECK(std::string("const") == ptr);
+            }
+        }
+
+        str_big_kill(&big);
+    }
+
+    GIVEN("string with '\\0'")
+    {
+        StrBig big;
+        REQUIRE(str_big_init_copy(&big, str_ref("a\0b", 3)));
+        CHECK(str_big_cstr(&big) == NULL);
+        str_big_kill(&big);
+    }
+}
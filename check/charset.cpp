@@ -0,0 +1,103 @@
+#include <str/charset.h>
+
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+
+static std::vector<std::string> split_all(char const * s, StrCharSet const * set)
+{
+    std::vector<std::string> ret;
+    StrSplit split;
+    str_split_init(&split, s ? str_ref_cstr(s) : str_ref_null(), set);
+    for(StrRef field; str_split_next(&split, &field); )
+        ret.emplace_back(field.ptr, field.len);
+    return ret;
+}
+
+TEST_CASE("StrCharSet", "[charset]")
+{
+    StrCharSet set;
+
+    GIVEN("separators")
+    {
+        str_charset_init(&set, str_ref_cstr(",;\t\r\n"));
+        CHECK(set.ascii);
+        CHECK(str_charset_has(&set, ','));
+        CHECK(str_charset_has(&set, '\n'));
+        CHECK(!str_charset_has(&set, ' '));
+        CHECK(!str_charset_has(&set, '\0'));
+        CHECK(!str_charset_has(&set, '\xac')); // ',' | 0x80
+
+        CHECK(str_ref_find_any(str_ref_cstr("abc;d,e"), &set) == 3);
+        CHECK(str_ref_find_any(str_ref_cstr("abc"), &set) == SIZE_MAX);
+        CHECK(str_ref_find_any(str_ref_null(), &set) == SIZE_MAX);
+
+        StrRef ref = str_ref_cstr("key\tvalue");
+        StrRef word = str_ref_word_any(&ref, &set);
+        CHECK(std::string(word.ptr, word.len) == "key");
+        CHECK(std::string(ref.ptr, ref.len) == "value");
+        word = str_ref_word_any(&ref, &set);
+        CHECK(std::string(word.ptr, word.len) == "value");
+        CHECK(ref.len == 0);
+    }
+
+    GIVEN("split iterator")
+    {
+        str_charset_init(&set, str_ref_cstr(",;"));
+        CHECK(split_all(nullptr, &set).empty());
+        CHECK(split_all("", &set) == std::vector<std::string>{ "" });
+        CHECK(split_all("a", &set) == std::vector<std::string>{ "a" });
+        CHECK(split_all("a,,b;", &set) == (std::vector<std::string>{ "a", "", "b", "" }));
+        CHECK(split_all(";x", &set) == (std::vector<std::string>{ "", "x" }));
+    }
+
+    GIVEN("sets and haystacks over all bytes")
+    {
+        std::string hay;
+        for(int i = 0; i < 4; ++i)
+            for(int c = 0; c < 256; ++c)
+                hay.push_back(char((c*7 + i*13) & 0xff));
+        char const * const sets[] = { "", ",", ",;\t\r\n", "\x7f\x01 ", "AZaz09",
+            "\x80", "\xff,", "\x90\x10" };
+        THEN("vectorized and tail positions match a byte loop")
+        {
+            for(char const * s : sets)
+            {
+                str_charset_init(&set, str_ref_cstr(s));
+                std::string const chars = s;
+                for(size_t beg = 0; beg < hay.size(); beg += 37)
+                    for(size_t len = 0; beg + len <= hay.size(); len += (len < 70 ? 1 : 61))
+                    {
+                        std::string const h = hay.substr(beg, len);
+                        size_t const pos = h.find_first_of(chars);
+                        CHECK(str_ref_find_any(str_ref(h.data(), len), &set)
+                            == (pos == std::string::npos ? SIZE_MAX : pos));
+                    }
+            }
+        }
+        THEN("bulk split matches the iterator")
+        {
+            StrRef out[7];
+            for(char const * s : sets)
+            {
+                str_charset_init(&set, str_ref_cstr(s));
+                for(size_t len = 0; len <= hay.size(); len += 29)
+                {
+                    StrRef const text = str_ref(hay.data(), len);
+                    std::vector<std::string> expect;
+                    StrSplit split;
+                    str_split_init(&split, text, &set);
+                    for(StrRef field; str_split_next(&split, &field); )
+                        expect.emplace_back(field.ptr, field.len);
+                    std::vector<std::string> got;
+                    StrRef ref = text;
+                    for(size_t n; (n = str_ref_split_any(&ref, &set, out, 7)); )
+                        for(size_t i = 0; i < n; ++i)
+                            got.emplace_back(out[i].ptr, out[i].len);
+                    CHECK(got == expect);
+                }
+            }
+        }
+    }
+}
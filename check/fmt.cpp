@@ -28,6 +28,33 @@ TEST_CASE("str_add_char", "[fmt]")
     CHECK( strcmp(tmp, "a") == 0 );
 }
 
+TEST_CASE("str_cpy_tolower", "[fmt]")
+{
+    char tmp[64];
+    char const src[] = "Content-Type: TEXT/html; charset=UTF-8 \xc3\x84";
+    size_t const src_len = sizeof(src) - 1;
+
+    char * dst = tmp;
+    size_t cap = src_len; // no room for terminator
+    CHECK( str_cpy_tolower(&dst, &cap, str_ref(src, src_len)) == src_len );
+    CHECK( !dst );
+    CHECK( cap == 0 );
+
+    CHECK( str_cpy_toupper(nullptr, nullptr, str_ref(src, src_len)) == src_len );
+
+    dst = tmp;
+    cap = sizeof(tmp);
+    CHECK( str_cpy_tolower(&dst, &cap, str_ref(src, src_len)) == src_len );
+    CHECK( dst == tmp + src_len );
+    CHECK( cap == sizeof(tmp) - src_len );
+    CHECK( strcmp(tmp, "content-type: text/html; charset=utf-8 \xc3\x84") == 0 );
+
+    dst = tmp;
+    cap = sizeof(tmp);
+    CHECK( str_cpy_toupper(&dst, &cap, str_ref(src, src_len)) == src_len );
+    CHECK( strcmp(tmp, "CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8 \xc3\x84") == 0 );
+}
+
 TEST_CASE("str_enc_www_form_component", "[fmt]")
 {
     char tmp[256];
@@ -0,0 +1,88 @@
+#include <str/intern.h>
+
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+
+TEST_CASE("StrIntern", "[intern]")
+{
+    StrIntern intern;
+    str_intern_init(&intern);
+
+    GIVEN("empty interner")
+    {
+        THEN("nothing is found")
+            CHECK(!str_intern_find(&intern, str_ref_cstr("key")).ptr);
+
+        THEN("null stays null")
+            CHECK(!str_intern(&intern, str_ref_null()).ptr);
+
+        THEN("no memory is used")
+        {
+            StrInternStats stats;
+            str_intern_stats(&intern, &stats);
+            CHECK(stats.count == 0);
+            CHECK(stats.memory == 0);
+        }
+    }
+
+    GIVEN("interned strings")
+    {
+        std::vector<std::string> keys;
+        for(int i = 0; i < 10000; ++i)
+            keys.push_back("x-header-" + std::to_string(i));
+        std::vector<StrRef> canon;
+        for(auto const & key : keys)
+            canon.push_back(str_intern(&intern, str_ref(key.data(), key.size())));
+
+        THEN("canonical copies are equal and zero-terminated")
+        {
+            for(size_t i = 0; i < keys.size(); ++i)
+            {
+                REQUIRE(canon[i].ptr);
+                CHECK(canon[i].ptr != keys[i].data());
+                CHECK(keys[i] == canon[i].ptr);
+            }
+        }
+
+        WHEN("interned again")
+        {
+            THEN("the same pointers are returned")
+            {
+                for(size_t i = 0; i < keys.size(); ++i)
+                {
+                    std::string const copy = keys[i];
+                    CHECK(str_intern(&intern, str_ref(copy.data(), copy.size())).ptr == canon[i].ptr);
+                    CHECK(str_intern_find(&intern, str_ref(copy.data(), copy.size())).ptr == canon[i].ptr);
+                }
+            }
+        }
+
+        THEN("memory is accounted")
+        {
+            StrInternStats stats;
+            str_intern_stats(&intern, &stats);
+            CHECK(stats.count == keys.size());
+            size_t bytes = 0;
+            for(auto const & key : keys)
+                bytes += key.size() + 1;
+            CHECK(stats.bytes == bytes);
+            CHECK(stats.memory > bytes);
+        }
+
+        WHEN("used as strings")
+        {
+            StrStr str;
+            REQUIRE(str_str_init_intern(&str, &intern, str_ref_cstr("x-header-42")));
+            THEN("cstr doesn't copy")
+            {
+                CHECK(!str_str_is_mutable(&str));
+                CHECK(str_str_cstr(&str) == canon[42].ptr);
+            }
+            str_str_kill(&str);
+        }
+    }
+
+    str_intern_kill(&intern);
+}
@@ -0,0 +1,149 @@
+#include <str/arena.h>
+#include <str/map.h>
+
+#include "catch.hpp"
+
+#include <map>
+#include <string>
+
+TEST_CASE("StrMap", "[map]")
+{
+    StrMap map;
+    str_map_init(&map);
+
+    GIVEN("empty map")
+    {
+        CHECK(str_map_len(&map) == 0);
+        CHECK(!str_map_find(&map, str_ref_cstr("key")));
+        CHECK(!str_map_erase(&map, str_ref_cstr("key"), nullptr));
+        size_t idx = 0;
+        CHECK(!str_map_next(&map, &idx));
+    }
+
+    GIVEN("short and long keys")
+    {
+        std::map<std::string, intptr_t> ref;
+        for(intptr_t i = 0; i < 5000; ++i)
+        {
+            std::string key = "k" + std::to_string(i);
+            if(i % 3 == 0)
+                key += std::string(40, 'x'); // longer than inline
+            bool added = false;
+            void ** val = str_map_insert(&map, str_ref(key.data(), key.size()), &added);
+            REQUIRE(val);
+            CHECK(added);
+            *val = (void*)i;
+            ref[key] = i;
+        }
+        CHECK(str_map_len(&map) == ref.size());
+
+        THEN("all keys are found")
+        {
+            for(auto const & kv : ref)
+            {
+                void ** val = str_map_find(&map, str_ref(kv.first.data(), kv.first.size()));
+                REQUIRE(val);
+                CHECK((intptr_t)*val == kv.second);
+            }
+            CHECK(!str_map_find(&map, str_ref_cstr("k")));
+            CHECK(!str_map_find(&map, str_ref_cstr("k5000")));
+        }
+
+        WHEN("inserted again")
+        {
+            bool added = true;
+            void ** val = str_map_insert(&map, str_ref_cstr("k1"), &added);
+            THEN("existing value is returned")
+            {
+                CHECK(!added);
+                CHECK((intptr_t)*val == 1);
+                CHECK(str_map_len(&map) == ref.size());
+            }
+        }
+
+        WHEN("every other key is erased")
+        {
+            for(auto it = ref.begin(); it != ref.end(); )
+            {
+                void * val = nullptr;
+                REQUIRE(str_map_erase(&map, str_ref(it->first.data(), it->first.size()), &val));
+                CHECK((intptr_t)val == it->second);
+                it = ref.erase(it);
+                if(it != ref.end())
+                    ++it;
+            }
+            THEN("the rest is still found")
+            {
+                CHECK(str_map_len(&map) == ref.size());
+                for(auto const & kv : ref)
+                {
+                    void ** val = str_map_find(&map, str_ref(kv.first.data(), kv.first.size()));
+                    REQUIRE(val);
+                    CHECK((intptr_t)*val == kv.second);
+                }
+            }
+            THEN("iteration visits the rest")
+            {
+                size_t idx = 0, cnt = 0;
+                for(StrMapSlot * slot; (slot = str_map_next(&map, &idx)); ++cnt)
+                {
+                    StrRef const key = str_str_ref(&slot->key);
+                    CHECK(ref.at(std::string(key.ptr, key.len)) == (intptr_t)slot->val);
+                }
+                CHECK(cnt == ref.size());
+            }
+        }
+    }
+
+    GIVEN("empty key")
+    {
+        REQUIRE(str_map_insert(&map, str_ref_cstr(""), nullptr));
+        THEN("null key finds it")
+            CHECK(str_map_find(&map, str_ref_null()));
+        THEN("null key erases it")
+        {
+            CHECK(str_map_erase(&map, str_ref_null(), nullptr));
+            CHECK(str_map_len(&map) == 0);
+        }
+    }
+
+    GIVEN("arena selected while inserting")
+    {
+        StrArena arena;
+        str_arena_init(&arena, 0);
+        StrAlloc const * old = str_alloc_set_thread(str_arena_allocator(&arena));
+        std::string const key(100, 'k');
+        REQUIRE(str_map_insert(&map, str_ref(key.data(), key.size()), nullptr));
+        str_alloc_set_thread(old);
+        str_arena_kill(&arena);
+        THEN("key is owned by the map")
+        {
+            size_t idx = 0;
+            StrMapSlot * slot = str_map_next(&map, &idx);
+            REQUIRE(slot);
+            CHECK(str_str_get_tag(&slot->key) == STR_TAG_STR);
+            CHECK(str_map_find(&map, str_ref(key.data(), key.size())));
+        }
+    }
+
+    GIVEN("key string")
+    {
+        StrStr key;
+        str_str_init_const(&key, str_ref_cstr("const-key-longer-than-inline-storage"));
+        char const * ptr = str_str_ptr(&key);
+        bool added = false;
+        REQUIRE(str_map_insert_move(&map, &key, &added));
+        THEN("it is moved into the map")
+        {
+            CHECK(added);
+            CHECK(str_str_is_null(&key));
+            size_t idx = 0;
+            StrMapSlot * slot = str_map_next(&map, &idx);
+            REQUIRE(slot);
+            CHECK(str_str_ptr(&slot->key) == ptr);
+        }
+        str_str_kill(&key);
+    }
+
+    str_map_kill(&map);
+}
@@ -2,6 +2,9 @@
 
 #include "catch.hpp"
 
+#include <string>
+#include <vector>
+
 void check_ref_behaves_empty(StrRef ref)
 {
     THEN("Ref behaves as empty")
@@ -36,3 +39,176 @@ TEST_CASE("StrRef construction", "[ref]")
     GIVEN("empty ref")
         check_ref_empty(str_ref_empty());  
 }
+
+TEST_CASE("StrRef substring search", "[ref]")
+{
+    GIVEN("edge cases")
+    {
+        StrRef const ref = str_ref_cstr("abcabc");
+        CHECK(str_ref_find(ref, str_ref_empty()) == 0);
+        CHECK(str_ref_rfind(ref, str_ref_empty()) == 6);
+        CHECK(str_ref_find(ref, str_ref_cstr("abcabcd")) == SIZE_MAX);
+        CHECK(str_ref_find(ref, str_ref_cstr("c")) == 2);
+        CHECK(str_ref_rfind(ref, str_ref_cstr("c")) == 5);
+        CHECK(str_ref_find(ref, ref) == 0);
+        CHECK(str_ref_rfind(ref, ref) == 0);
+        CHECK(str_ref_find(str_ref_null(), str_ref_cstr("a")) == SIZE_MAX);
+    }
+
+    GIVEN("haystacks of all lengths over small alphabet")
+    {
+        // matches of the first and last byte are frequent, so all
+        // block and tail paths see candidates and false positives
+        std::string hay;
+        unsigned x = 1;
+        for(int i = 0; i < 300; ++i)
+        {
+            x = x*1103515245u + 12345u;
+            hay.push_back("ab\r\n"[(x>>16) % 4]);
+        }
+        char const * const subs[] = { "\r\n", "\r\n\r\n", "aba", "abba\r",
+            "\r\na\r\nb\r\na", "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb" };
+        THEN("results match std::string")
+        {
+            for(size_t len = 0; len <= hay.size(); ++len)
+            {
+                std::string const h = hay.substr(0, len);
+                for(char const * s : subs)
+                {
+                    CHECK(str_ref_find(str_ref(h.data(), len), str_ref_cstr(s)) == h.find(s));
+                    CHECK(str_ref_rfind(str_ref(h.data(), len), str_ref_cstr(s)) == h.rfind(s));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("StrRef bulk split", "[ref]")
+{
+    StrRef out[64];
+
+    GIVEN("edge cases")
+    {
+        StrRef ref = str_ref_null();
+        CHECK(str_ref_split_c(&ref, ',', out, 64) == 0);
+        ref = str_ref_empty();
+        CHECK(str_ref_split_c(&ref, ',', out, 0) == 0);
+        CHECK(!str_ref_is_null(ref));
+        REQUIRE(str_ref_split_c(&ref, ',', out, 64) == 1);
+        CHECK(out[0].len == 0);
+        CHECK(str_ref_is_null(ref));
+        ref = str_ref_cstr("a,,b,");
+        REQUIRE(str_ref_split_c(&ref, ',', out, 64) == 4);
+        CHECK(std::string(out[0].ptr, out[0].len) == "a");
+        CHECK(out[1].len == 0);
+        CHECK(std::string(out[2].ptr, out[2].len) == "b");
+        CHECK(out[3].len == 0);
+        CHECK(str_ref_is_null(ref));
+    }
+
+    GIVEN("lines of all lengths")
+    {
+        std::string text;
+        unsigned x = 1;
+        for(int i = 0; i < 400; ++i)
+        {
+            x = x*1103515245u + 12345u;
+            text.push_back((x>>16) % 5 ? 'a' : '\n');
+        }
+        THEN("fields match str_ref_word_c for any array size")
+        {
+            for(size_t len = 0; len <= text.size(); ++len)
+            {
+                std::vector<std::string> expect;
+                StrRef ref = str_ref(text.data(), len);
+                for(;;)
+                {
+                    StrRef const word = str_ref_word_c(&ref, '\n');
+                    expect.emplace_back(word.ptr, word.len);
+                    if(word.ptr + word.len == text.data() + len)
+                        break;
+                }
+                for(size_t cnt : { 1, 3, 64 })
+                {
+                    std::vector<std::string> got;
+                    ref = str_ref(text.data(), len);
+                    for(size_t n; (n = str_ref_split_c(&ref, '\n', out, cnt)); )
+                        for(size_t i = 0; i < n; ++i)
+                        {
+                            CHECK(out[i].ptr >= text.data());
+                            got.emplace_back(out[i].ptr, out[i].len);
+                        }
+                    CHECK(got == expect);
+                }
+            }
+        }
+    }
+}
+
+static int sign(int x)
+{
+    return (x > 0) - (x < 0);
+}
+
+static std::string lower(std::string s)
+{
+    for(char & c : s)
+        if(c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+    return s;
+}
+
+TEST_CASE("StrRef comparison", "[ref]")
+{
+    GIVEN("edge cases")
+    {
+        StrRef const abc = str_ref_cstr("abc");
+        CHECK(str_ref_cmp(str_ref_null(), str_ref_empty()) == 0);
+        CHECK(str_ref_cmp(str_ref_null(), abc) < 0);
+        CHECK(str_ref_cmp(abc, str_ref_cstr("ab")) > 0);
+        CHECK(str_ref_cmp(abc, str_ref_cstr("abd")) < 0);
+        CHECK(str_ref_cmp(str_ref_cstr("\xff"), abc) > 0);
+        CHECK(str_ref_cmp_eq_ci(str_ref_null(), str_ref_empty()));
+        CHECK(str_ref_cmp_eq_ci(str_ref_cstr("Content-LENGTH"), str_ref_cstr("content-length")));
+        CHECK(!str_ref_cmp_eq_ci(str_ref_cstr("content-length"), str_ref_cstr("content-lengt")));
+        CHECK(str_ref_cmp_ci(str_ref_cstr("ABC"), str_ref_cstr("abd")) < 0);
+        CHECK(str_ref_cmp_ci(str_ref_cstr("_"), str_ref_cstr("A")) < 0); // "_" < "a", but "_" > "A"
+
+        CHECK(str_ref_starts_with(abc, str_ref_null()));
+        CHECK(str_ref_starts_with(str_ref_null(), str_ref_empty()));
+        CHECK(str_ref_starts_with(abc, str_ref_cstr("ab")));
+        CHECK(!str_ref_starts_with(abc, str_ref_cstr("abcd")));
+        CHECK(!str_ref_starts_with(abc, str_ref_cstr("b")));
+        CHECK(str_ref_ends_with(abc, str_ref_cstr("bc")));
+        CHECK(!str_ref_ends_with(abc, str_ref_cstr("ab")));
+        CHECK(str_ref_starts_with_ci(str_ref_cstr("Accept-Encoding"), str_ref_cstr("ACCEPT-")));
+        CHECK(!str_ref_starts_with_ci(str_ref_cstr("Accept"), str_ref_cstr("ACCEPT-")));
+        CHECK(str_ref_ends_with_ci(str_ref_cstr("www.Example.COM"), str_ref_cstr(".example.com")));
+        CHECK(!str_ref_ends_with_ci(str_ref_cstr("www.example.org"), str_ref_cstr(".example.com")));
+    }
+
+    GIVEN("strings differing in one byte at any position")
+    {
+        // bytes around letter ranges and with the msb set
+        char const bytes[] = { 'A', 'a', 'Z', 'z', '@', '[', '`', '{', '\xc1', '\xe1', '\xda', '0' };
+        std::string const base = "X-Forwarded-For-Some-Long-Header-Name";
+        THEN("results match comparison of lower case strings")
+        {
+            for(size_t len = 0; len <= base.size(); ++len)
+                for(size_t pos = 0; pos < len; ++pos)
+                    for(char x : bytes)
+                        for(char y : bytes)
+                        {
+                            std::string a = base.substr(0, len), b = lower(a);
+                            a[pos] = x;
+                            b[pos] = y;
+                            StrRef const ra = str_ref(a.data(), a.size()), rb = str_ref(b.data(), b.size());
+                            CHECK(sign(str_ref_cmp(ra, rb)) == sign(a.compare(b)));
+                            CHECK(str_ref_cmp_eq_ci(ra, rb) == (lower(a) == lower(b)));
+                            CHECK(sign(str_ref_cmp_ci(ra, rb)) == sign(lower(a).compare(lower(b))));
+                            CHECK(str_ref_starts_with_ci(str_ref(a.data(), len), str_ref(b.data(), pos + 1))
+                                == (lower(a) == lower(b)));
+                        }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#include <str/ref_b16.h>
+
+#include "catch.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <string>
+
+static std::string hex(std::string const & src, bool upper)
+{
+    std::string ret;
+    char tmp[3];
+    for(char c : src)
+    {
+        std::snprintf(tmp, sizeof(tmp), upper ? "%02X" : "%02x", (unsigned char)c);
+        ret += tmp;
+    }
+    return ret;
+}
+
+TEST_CASE("Base16", "[b16]")
+{
+    std::string src;
+    for(int i = 0; i < 3*256; ++i)
+        src.push_back(char(i*7 + i/256));
+
+    GIVEN("buffers of all lengths")
+    {
+        THEN("encoding matches printf and decoding restores the input")
+        {
+            for(size_t len = 0; len <= 300; ++len)
+            {
+                std::string const in = src.substr(len % 13, len);
+                std::string out(2*len + 1, '\x55');
+                str_encode_b16(&out[0], str_ref(in.data(), len));
+                CHECK(out.c_str() == hex(in, false));
+                str_encode_B16(&out[0], str_ref(in.data(), len));
+                CHECK(out.c_str() == hex(in, true));
+
+                std::string dec(len + 1, '\x55');
+                REQUIRE(str_decode_b16(&dec[0], str_ref(out.data(), 2*len)));
+                CHECK(dec[len] == '\0');
+                CHECK(dec.substr(0, len) == in);
+            }
+        }
+    }
+
+    GIVEN("invalid input")
+    {
+        char dec[64];
+        CHECK(str_decode_b16_size(3) == -1);
+        CHECK(!str_decode_b16(dec, str_ref_cstr("abc")));
+        CHECK(str_decode_b16(dec, str_ref_cstr("")));
+        CHECK(str_decode_b16(dec, str_ref_cstr("aBcD")));
+        CHECK(!str_decode_b16(dec, str_ref_cstr("0g")));
+        CHECK(!str_decode_b16(dec, str_ref_cstr("0:")));
+        CHECK(!str_decode_b16(dec, str_ref_cstr("/0")));
+        CHECK(!str_decode_b16(dec, str_ref_cstr("@0")));
+        CHECK(!str_decode_b16(dec, str_ref_cstr("0\xc1")));
+    }
+
+    GIVEN("long input with mixed case")
+    {
+        std::string in = hex(src.substr(0, 100), false);
+        for(size_t i = 0; i < in.size(); i += 3)
+            in[i] = char(std::toupper((unsigned char)in[i]));
+        std::string dec(101, '\0');
+        REQUIRE(str_decode_b16(&dec[0], str_ref(in.data(), in.size())));
+        CHECK(dec.substr(0, 100) == src.substr(0, 100));
+
+        THEN("a bad character at any position is detected")
+        {
+            char const bad[] = { '/', ':', '@', 'G', '`', 'g', '\0', ' ', '\xb0', '\xe1' };
+            for(size_t i = 0; i < in.size(); ++i)
+                for(char c : bad)
+                {
+                    std::string tmp = in;
+                    tmp[i] = c;
+                    CHECK(!str_decode_b16(&dec[0], str_ref(tmp.data(), tmp.size())));
+                }
+        }
+    }
+}
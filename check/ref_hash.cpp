@@ -0,0 +1,58 @@
+#include <str/ref_hash.h>
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <set>
+#include <string>
+
+TEST_CASE("StrRef hash", "[ref]")
+{
+    GIVEN("reference vectors of wyhash")
+    {
+        char const * const msg[] = { "", "a", "abc", "message digest",
+            "abcdefghijklmnopqrstuvwxyz",
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+            "12345678901234567890123456789012345678901234567890123456789012345678901234567890" };
+        uint64_t const hash[] = { 0x93228a4de0eec5a2ull, 0xc5bac3db178713c4ull,
+            0xa97f2f7b1d9b3314ull, 0x786d1f1df3801df4ull, 0xdca5a8138ad37c87ull,
+            0xb9e734f117cfaf70ull, 0x6cc5eab49a92d617ull };
+        THEN("hashes match")
+        {
+            for(int i = 0; i < 7; ++i)
+                CHECK(str_ref_hash(str_ref_cstr(msg[i]), i) == hash[i]);
+        }
+    }
+
+    GIVEN("strings of all lengths up to 200")
+    {
+        std::string mixed;
+        for(int i = 0; i < 200; ++i)
+            mixed.push_back("aBc-Z@[`{\xc1\xe1"[i % 12]);
+        std::string lower = mixed;
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+            [](char c) { return c >= 'A' && c <= 'Z' ? c + 32 : c; });
+
+        THEN("case-insensitive hash equals hash of lower case")
+        {
+            for(size_t len = 0; len <= mixed.size(); ++len)
+            {
+                CHECK(str_ref_hash_ci(str_ref(mixed.data(), len), 7)
+                    == str_ref_hash(str_ref(lower.data(), len), 7));
+                CHECK(str_ref_hash_ci(str_ref(mixed.data(), len), 7)
+                    == str_ref_hash_ci(str_ref(lower.data(), len), 7));
+            }
+        }
+
+        THEN("different prefixes and seeds give different hashes")
+        {
+            std::set<uint64_t> seen;
+            for(size_t len = 0; len <= mixed.size(); ++len)
+            {
+                seen.insert(str_ref_hash(str_ref(mixed.data(), len), 0));
+                seen.insert(str_ref_hash(str_ref(mixed.data(), len), 1));
+            }
+            CHECK(seen.size() == 2*(mixed.size()+1));
+        }
+    }
+}
@@ -115,4 +115,778 @@ TEST_CASE("StrStr construction", "[str]")
         CHECK(str_str_len(&str) == 4);
         CHECK(str_ref_cmp_eq(str_str_ref(&str), str_ref_cstr("test")));
     }
+
+    GIVEN("null by copy init")
+    {
+        StrStr str;
+        CHECK(str_str_init_copy(&str, str_ref_null()));
+
+        check_str_null(&str);
+    }
+
+    GIVEN("empty by copy init")
+    {
+        StrStr str;
+        CHECK(str_str_init_copy(&str, str_ref_empty()));
+
+        check_str_empty(&str);
+    }
+
+    GIVEN("copies of various lengths")
+    {
+        std::string const src(100, 'x');
+        for(size_t len = 0; len < src.size(); ++len)
+        {
+            CAPTURE(len);
+            StrStr str;
+            REQUIRE(str_str_init_copy(&str, str_ref(src.data(), len)));
+            CHECK(str_str_is_mutable(&str));
+            CHECK(str_str_cap(&str) >= (int)len);
+            CHECK(str_str_len(&str) == (int)len);
+            CHECK(src.substr(0, len) == str_str_ptr(&str));
+            str_str_kill(&str);
+        }
+    }
+
+    GIVEN("batch of copies")
+    {
+        std::string const a(100, 'a'), b(10, 'b'), c(50, 'c');
+        StrRef const refs[] = { str_ref(a.data(), a.size()),
+            str_ref(b.data(), b.size()), str_ref(c.data(), c.size()) };
+        StrStr strs[3];
+        void * mem;
+        REQUIRE(str_str_init_copy_n(strs, refs, 3, &mem));
+        CHECK(mem);
+        CHECK(a == str_str_ptr(strs + 0));
+        CHECK(b == str_str_ptr(strs + 1));
+        CHECK(c == str_str_ptr(strs + 2));
+
+        WHEN("copy is modified")
+        {
+            REQUIRE(str_str_cat(strs + 0, refs[1]));
+            CHECK(a + b == str_str_ptr(strs + 0));
+            CHECK(c == str_str_ptr(strs + 2));
+        }
+
+        str_str_kill_n(strs, 3, mem);
+    }
+
+    GIVEN("batch of short copies")
+    {
+        StrRef const refs[] = { str_ref_cstr("a"), str_ref_cstr("bc") };
+        StrStr strs[2];
+        void * mem;
+        REQUIRE(str_str_init_copy_n(strs, refs, 2, &mem));
+        CHECK(!mem);
+        CHECK(std::string("bc") == str_str_ptr(strs + 1));
+        str_str_kill_n(strs, 2, mem);
+    }
+}
+
+TEST_CASE("StrStr append", "[str]")
+{
+    GIVEN("empty")
+    {
+        StrStr str;
+        str_str_init_empty(&str);
+
+        WHEN("appended many times")
+        {
+            std::string ref;
+            for(int i = 0; i < 1000; ++i)
+            {
+                REQUIRE(str_str_cat(&str, str_ref("abc", 3)));
+                ref += "abc";
+            }
+            THEN("contents are concatenated")
+            {
+                CHECK(str_str_len(&str) == (int)ref.size());
+                CHECK(ref == str_str_ptr(&str));
+            }
+            THEN("capacity grows geometrically")
+            {
+                CHECK(str_str_cap(&str) >= str_str_len(&str));
+                CHECK(str_str_cap(&str) < 2*str_str_len(&str));
+            }
+        }
+
+        WHEN("exact growth is set")
+        {
+            unsigned const old = str_str_set_growth(100);
+            std::string const ref(STR_SSO_CAP+1, 'x');
+            REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+            REQUIRE(str_str_cat(&str, str_ref("x", 1)));
+            CHECK(str_str_cap(&str) == (int)STR_SSO_CAP+2);
+            CHECK(str_str_set_growth(old) == 100);
+        }
+
+        str_str_kill(&str);
+    }
+
+    GIVEN("const")
+    {
+        StrStr str;
+        str_str_init_const(&str, str_ref_cstr("test"));
+
+        WHEN("nothing is appended")
+        {
+            CHECK(str_str_cat(&str, str_ref_empty()));
+            THEN("string is untouched")
+                CHECK(!str_str_is_mutable(&str));
+        }
+
+        WHEN("appended")
+        {
+            REQUIRE(str_str_cat(&str, str_ref_cstr("ing")));
+            THEN("string is copied")
+            {
+                CHECK(str_str_is_mutable(&str));
+                CHECK(std::string("testing") == str_str_ptr(&str));
+            }
+        }
+
+        str_str_kill(&str);
+    }
+}
+
+TEST_CASE("StrStr allocation", "[str]")
+{
+    GIVEN("long string")
+    {
+        StrStr str;
+        str_str_init_empty(&str);
+        std::string ref(1000, 'x');
+        REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+
+        WHEN("grown while keeping contents")
+        {
+            REQUIRE(str_str_alloc(&str, 1000000, INT_MAX));
+            THEN("contents are kept")
+            {
+                CHECK(str_str_cap(&str) == 1000000);
+                CHECK(ref == str_str_ptr(&str));
+            }
+        }
+
+        WHEN("grown while keeping a prefix")
+        {
+            REQUIRE(str_str_alloc(&str, 1000000, 10));
+            THEN("prefix is kept")
+                CHECK(std::string(10, 'x') == str_str_ptr(&str));
+        }
+
+        WHEN("grown without keeping contents")
+        {
+            REQUIRE(str_str_alloc(&str, 1000000, -1));
+            THEN("string is empty")
+            {
+                CHECK(str_str_cap(&str) == 1000000);
+                CHECK(str_str_is_empty(&str));
+                CHECK(*str_str_ptr(&str) == '\0');
+            }
+        }
+
+        str_str_kill(&str);
+    }
+}
+
+TEST_CASE("StrStr multi-piece append", "[str]")
+{
+    StrStr str;
+    str_str_init_const(&str, str_ref_cstr("https"));
+
+    GIVEN("array of pieces")
+    {
+        StrRef const refs[] = { str_ref_cstr("://"), str_ref_cstr("example.com"),
+            str_ref_null(), str_ref_cstr("/path"), str_ref_cstr("?"), str_ref_cstr("q=1") };
+        REQUIRE(str_str_catv(&str, refs, sizeof(refs)/sizeof(refs[0])));
+        CHECK(std::string("https://example.com/path?q=1") == str_str_ptr(&str));
+    }
+
+    GIVEN("no pieces")
+    {
+        REQUIRE(str_str_catv(&str, nullptr, 0));
+        THEN("string is untouched")
+            CHECK(!str_str_is_mutable(&str));
+    }
+
+    GIVEN("variadic pieces")
+    {
+        REQUIRE(str_str_catv(&str, str_ref_cstr("://"), str_ref_cstr("host"), str_ref_cstr("/")));
+        CHECK(std::string("https://host/") == str_str_ptr(&str));
+    }
+
+    GIVEN("too long pieces")
+    {
+        StrRef const refs[] = { str_ref("x", INT_MAX), str_ref("x", 1) };
+        CHECK(!str_str_catv(&str, refs, 2));
+        CHECK(std::string("https") == str_str_ptr(&str));
+    }
+
+    str_str_kill(&str);
+}
+
+TEST_CASE("StrStr formatting", "[str]")
+{
+    std::string const ref(1000, 'x');
+
+    GIVEN("short string")
+    {
+        StrStr str;
+        str_str_init_copy(&str, str_ref_cstr("old"));
+
+        WHEN("formatted")
+        {
+            REQUIRE(str_str_fmt(&str, "%d abc %d %s", 123, 456, "def"));
+            CHECK(std::string("123 abc 456 def") == str_str_ptr(&str));
+            CHECK(str_str_len(&str) == 15);
+        }
+
+        WHEN("formatted long")
+        {
+            REQUIRE(str_str_fmt(&str, "%s-%d", ref.c_str(), 1));
+            CHECK(ref + "-1" == str_str_ptr(&str));
+        }
+
+        WHEN("formatted in one pass")
+        {
+            REQUIRE(str_str_fmt_stream(&str, "%d abc %d %s", 123, 456, "def"));
+            CHECK(std::string("123 abc 456 def") == str_str_ptr(&str));
+        }
+
+        WHEN("formatted long in one pass")
+        {
+            REQUIRE(str_str_fmt_stream(&str, "%s-%d-%s", ref.c_str(), 1, ref.c_str()));
+            CHECK(ref + "-1-" + ref == str_str_ptr(&str));
+            CHECK(str_str_len(&str) == 2003);
+        }
+
+        WHEN("formatted empty in one pass")
+        {
+            REQUIRE(str_str_fmt_stream(&str, "%s", ""));
+            CHECK(str_str_is_empty(&str));
+            CHECK(*str_str_ptr(&str) == '\0');
+        }
+
+        str_str_kill(&str);
+    }
+
+    GIVEN("null string")
+    {
+        StrStr str;
+        str_str_init_null(&str);
+
+        WHEN("formatted empty")
+        {
+            REQUIRE(str_str_fmt(&str, "%s", ""));
+            check_str_empty(&str);
+        }
+
+        WHEN("formatted")
+        {
+            REQUIRE(str_str_fmt(&str, "%d", 42));
+            CHECK(std::string("42") == str_str_ptr(&str));
+        }
+
+        WHEN("appended empty")
+        {
+            REQUIRE(str_str_fmt_cat(&str, "%s", ""));
+            check_str_null(&str);
+        }
+
+        WHEN("appended")
+        {
+            REQUIRE(str_str_fmt_cat(&str, "%d", 42));
+            CHECK(std::string("42") == str_str_ptr(&str));
+        }
+
+        str_str_kill(&str);
+    }
+
+    GIVEN("string built by appending")
+    {
+        StrStr str;
+        str_str_init_null(&str);
+        std::string exp;
+        for(int i = 0; i < 100; ++i)
+        {
+            REQUIRE(str_str_fmt_cat(&str, "%d=%s;", i, i%10 ? "v" : ref.c_str()));
+            exp += std::to_string(i) + "=" + (i%10 ? "v" : ref) + ";";
+        }
+        CHECK(str_str_len(&str) == (int)exp.size());
+        CHECK(exp == str_str_ptr(&str));
+
+        WHEN("nothing is appended")
+        {
+            int const cap = str_str_cap(&str);
+            REQUIRE(str_str_fmt_cat(&str, "%s", ""));
+            CHECK(str_str_cap(&str) == cap);
+            CHECK(exp == str_str_ptr(&str));
+        }
+
+        str_str_kill(&str);
+    }
+
+    GIVEN("const string")
+    {
+        StrStr str;
+        str_str_init_const(&str, str_ref_cstr("const"));
+
+        WHEN("appended")
+        {
+            REQUIRE(str_str_fmt_cat(&str, "-%d", 42));
+            CHECK(std::string("const-42") == str_str_ptr(&str));
+        }
+
+        WHEN("appended empty")
+        {
+            char const * ptr = str_str_ptr(&str);
+            REQUIRE(str_str_fmt_cat(&str, "%s", ""));
+            THEN("it is not copied")
+            {
+                CHECK(!str_str_is_mutable(&str));
+                CHECK(str_str_ptr(&str) == ptr);
+            }
+        }
+
+        REQUIRE(str_str_fmt_stream(&str, "%s", ref.c_str()));
+        CHECK(ref == str_str_ptr(&str));
+        str_str_kill(&str);
+    }
+
+    GIVEN("const empty string")
+    {
+        StrStr str;
+        str_str_init_const(&str, str_ref_cstr(""));
+
+        WHEN("appended empty")
+        {
+            REQUIRE(str_str_fmt_cat(&str, "%s", ""));
+            check_str_empty(&str);
+        }
+
+        WHEN("formatted empty")
+        {
+            REQUIRE(str_str_fmt(&str, "%s", ""));
+            check_str_empty(&str);
+        }
+
+        str_str_kill(&str);
+    }
+}
+
+TEST_CASE("StrStr sharing", "[str]")
+{
+    std::string const ref(100, 'x');
+
+    GIVEN("long string")
+    {
+        StrStr str;
+        REQUIRE(str_str_init_copy(&str, str_ref(ref.data(), ref.size())));
+        CHECK(!str_str_is_shared(&str));
+
+        WHEN("shared")
+        {
+            StrStr cpy;
+            REQUIRE(str_str_init_share(&cpy, &str));
+            THEN("both strings reference the same contents")
+            {
+                CHECK(str_str_is_shared(&str));
+                CHECK(str_str_is_shared(&cpy));
+                CHECK(str_str_ptr(&cpy) == str_str_ptr(&str));
+                CHECK(ref == str_str_ptr(&cpy));
+            }
+
+            WHEN("shared again")
+            {
+                StrStr cpy2;
+                REQUIRE(str_str_init_share(&cpy2, &cpy));
+                CHECK(str_str_ptr(&cpy2) == str_str_ptr(&str));
+                str_str_kill(&cpy2);
+            }
+
+            WHEN("copy is modified")
+            {
+                REQUIRE(str_str_cat(&cpy, str_ref_cstr("y")));
+                THEN("contents are copied")
+                {
+                    CHECK(!str_str_is_shared(&cpy));
+                    CHECK(str_str_ptr(&cpy) != str_str_ptr(&str));
+                    CHECK(ref + "y" == str_str_ptr(&cpy));
+                    CHECK(ref == str_str_ptr(&str));
+                }
+            }
+
+            WHEN("original is modified in place")
+            {
+                str_str_ptr_mut(&str)[0] = 'y';
+                THEN("copy is unchanged")
+                {
+                    CHECK(ref == str_str_ptr(&cpy));
+                    CHECK('y' == str_str_ptr(&str)[0]);
+                }
+            }
+
+            WHEN("copy is appended empty format")
+            {
+                REQUIRE(str_str_fmt_cat(&cpy, "%s", ""));
+                THEN("contents stay shared")
+                {
+                    CHECK(str_str_is_shared(&cpy));
+                    CHECK(str_str_ptr(&cpy) == str_str_ptr(&str));
+                }
+            }
+
+            WHEN("copy is appended format")
+            {
+                REQUIRE(str_str_fmt_cat(&cpy, "%d", 1));
+                THEN("contents are copied")
+                {
+                    CHECK(!str_str_is_shared(&cpy));
+                    CHECK(ref + "1" == str_str_ptr(&cpy));
+                    CHECK(ref == str_str_ptr(&str));
+                }
+            }
+
+            WHEN("copy is released")
+            {
+                str_str_set_empty(&cpy);
+                THEN("original is the only owner")
+                    CHECK(str_str_ptr_mut(&str) == str_str_ptr(&str));
+            }
+
+            str_str_kill(&cpy);
+        }
+
+        str_str_kill(&str);
+    }
+
+    GIVEN("short string")
+    {
+        StrStr str, cpy;
+        REQUIRE(str_str_init_copy(&str, str_ref_cstr("short")));
+        REQUIRE(str_str_init_share(&cpy, &str));
+        CHECK(!str_str_is_shared(&cpy));
+        CHECK(std::string("short") == str_str_ptr(&cpy));
+        str_str_kill(&cpy);
+        str_str_kill(&str);
+    }
+
+    GIVEN("weak string")
+    {
+        char buf[128] = "";
+        StrStr str, cpy;
+        str_str_init_weak(&str, buf, 0, sizeof(buf));
+        REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+        REQUIRE(str_str_init_share(&cpy, &str));
+        THEN("contents are copied")
+        {
+            CHECK(str_str_ptr(&cpy) != buf);
+            CHECK(ref == str_str_ptr(&cpy));
+        }
+        str_str_kill(&cpy);
+        str_str_kill(&str);
+    }
+}
+
+TEST_CASE("StrStr terminator", "[str]")
+{
+    char buf[] = "first\0second-part-long-enough\0third";
+    StrRef const first = str_ref(buf, 5);
+    StrRef const second = str_ref(buf + 6, 23);
+
+    GIVEN("const reference")
+    {
+        StrStr str;
+        str_str_init_const(&str, second);
+        CHECK(!str_str_get_rterm(&str));
+        THEN("cstr copies")
+        {
+            char const * ptr = str_str_cstr(&str);
+            CHECK(ptr != buf + 6);
+            CHECK(std::string("second-part-long-enough") == ptr);
+        }
+        str_str_kill(&str);
+    }
+
+    GIVEN("const reference with readable terminator")
+    {
+        StrStr str;
+        str_str_init_const_rterm(&str, second);
+        CHECK(str_str_get_rterm(&str));
+        CHECK(!str_str_is_mutable(&str));
+        THEN("cstr doesn't copy")
+            CHECK(str_str_cstr(&str) == buf + 6);
+
+        WHEN("terminator is not zero")
+        {
+            str_str_set_const_rterm(&str, str_ref(buf + 6, 6));
+            THEN("cstr copies")
+                CHECK(std::string("second") == str_str_cstr(&str));
+        }
+        str_str_kill(&str);
+    }
+
+    GIVEN("weak reference to zero terminated string")
+    {
+        StrStr str;
+        str_str_init_weak(&str, buf, -1, 0);
+        CHECK(str_str_get_rterm(&str));
+        CHECK(str_str_cstr(&str) == buf);
+        str_str_kill(&str);
+    }
+
+    GIVEN("substrings")
+    {
+        StrStr src, sub;
+        str_str_init_const(&src, str_ref(buf, sizeof(buf)-1));
+
+        WHEN("substring doesn't reach the end")
+        {
+            str_str_init_substr(&sub, &src, 0, first.len);
+            THEN("it is read-term")
+            {
+                CHECK(str_str_get_rterm(&sub));
+                CHECK(str_str_cstr(&sub) == buf);
+            }
+        }
+
+        WHEN("substring reaches the end of none-term string")
+        {
+            str_str_init_substr(&sub, &src, 30, 100);
+            THEN("it is none-term")
+            {
+                CHECK(!str_str_get_rterm(&sub));
+                CHECK(std::string("third") == str_str_cstr(&sub));
+            }
+        }
+
+        str_str_kill(&sub);
+        str_str_kill(&src);
+    }
+}
+
+TEST_CASE("StrStr cstr cache", "[str]")
+{
+    std::string ref(1000, 'x');
+
+    GIVEN("long string")
+    {
+        StrStr str;
+        str_str_init_empty(&str);
+        REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+        CHECK(!str_str_get_nul_free(&str));
+
+        WHEN("converted to cstr")
+        {
+            char const * ptr = str_str_cstr(&str);
+            REQUIRE(ptr);
+            THEN("result is cached")
+            {
+                CHECK(str_str_get_nul_free(&str));
+                CHECK(str_str_cstr(&str) == ptr);
+                CHECK(str_str_ptr(&str) == ptr);
+                CHECK(ref == ptr);
+            }
+
+            AND_WHEN("mutable contents are accessed")
+            {
+                char * mut = str_str_ptr_mut(&str);
+                REQUIRE(mut);
+                mut[10] = '\0';
+                THEN("contents are checked again")
+                {
+                    CHECK(!str_str_get_nul_free(&str));
+                    CHECK(str_str_cstr(&str) == NULL);
+                }
+            }
+
+            AND_WHEN("appended to")
+            {
+                REQUIRE(str_str_cat(&str, str_ref("\0", 1)));
+                THEN("contents are checked again")
+                    CHECK(str_str_cstr(&str) == NULL);
+            }
+
+            AND_WHEN("shared")
+            {
+                StrStr cpy;
+                REQUIRE(str_str_init_share(&cpy, &str));
+                REQUIRE(str_str_cstr(&cpy));
+                CHECK(str_str_get_nul_free(&cpy));
+                REQUIRE(str_str_cat(&cpy, str_ref("y", 1)));
+                THEN("copy on write doesn't keep the cache")
+                {
+                    CHECK(!str_str_get_nul_free(&cpy));
+                    CHECK(ref + "y" == str_str_cstr(&cpy));
+                    CHECK(ref == str_str_cstr(&str));
+                }
+                str_str_kill(&cpy);
+            }
+        }
+
+        str_str_kill(&str);
+    }
+
+    GIVEN("long mutable weak string")
+    {
+        char buf[100] = "weak-string-longer-than-sso";
+        StrStr str;
+        str_str_init_weak(&str, buf, -1, sizeof(buf)-1);
+        REQUIRE(str_str_cstr(&str) == buf);
+        THEN("result is not cached, owner may modify it")
+            CHECK(!str_str_get_nul_free(&str));
+        str_str_kill(&str);
+    }
+}
+
+TEST_CASE("StrStr case conversion", "[str]")
+{
+    std::string const mixed = "Accept-Encoding: GZIP, deflate; Q=0.5";
+
+    GIVEN("const string")
+    {
+        StrStr str;
+        str_str_init_const(&str, str_ref(mixed.data(), mixed.size()));
+        REQUIRE(str_str_tolower(&str));
+        THEN("contents are copied and converted")
+        {
+            CHECK(str_str_ptr(&str) != mixed.data());
+            CHECK(std::string("accept-encoding: gzip, deflate; q=0.5") == str_str_cstr(&str));
+            CHECK(mixed == "Accept-Encoding: GZIP, deflate; Q=0.5");
+        }
+        str_str_kill(&str);
+    }
+
+    GIVEN("short string")
+    {
+        StrStr str;
+        REQUIRE(str_str_init_copy(&str, str_ref_cstr("Host")));
+        REQUIRE(str_str_toupper(&str));
+        CHECK(std::string("HOST") == str_str_cstr(&str));
+        str_str_kill(&str);
+    }
+
+    GIVEN("shared string")
+    {
+        StrStr str, cpy;
+        REQUIRE(str_str_init_copy(&str, str_ref(mixed.data(), mixed.size())));
+        REQUIRE(str_str_init_share(&cpy, &str));
+        REQUIRE(str_str_toupper(&cpy));
+        THEN("only the converted copy changes")
+        {
+            CHECK(mixed == str_str_cstr(&str));
+            CHECK(std::string("ACCEPT-ENCODING: GZIP, DEFLATE; Q=0.5") == str_str_cstr(&cpy));
+        }
+        str_str_kill(&cpy);
+        str_str_kill(&str);
+    }
+
+    GIVEN("null string")
+    {
+        StrStr str;
+        str_str_init_null(&str);
+        CHECK(str_str_tolower(&str));
+        CHECK(str_str_is_null(&str));
+    }
+}
+
+TEST_CASE("StrStr reserve and shrink", "[str]")
+{
+    std::string const ref(100, 'x');
+
+    GIVEN("empty string")
+    {
+        StrStr str;
+        str_str_init_empty(&str);
+
+        WHEN("reserved")
+        {
+            REQUIRE(str_str_reserve(&str, 1000));
+            CHECK(str_str_cap(&str) == 1000);
+            REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+
+            THEN("appends up to the capacity don't reallocate")
+            {
+                char const * ptr = str_str_ptr(&str);
+                for(int i = 0; i < 9; ++i)
+                    REQUIRE(str_str_cat(&str, str_ref(ref.data(), ref.size())));
+                CHECK(str_str_ptr(&str) == ptr);
+                CHECK(str_str_len(&str) == 1000);
+            }
+
+            AND_WHEN("reserved less")
+            {
+                REQUIRE(str_str_reserve(&str, 10));
+                THEN("nothing changes")
+                {
+                    CHECK(str_str_cap(&str) == 1000);
+                    CHECK(ref == str_str_ptr(&str));
+                }
+            }
+
+            AND_WHEN("shrunk")
+            {
+                REQUIRE(str_str_shrink_to_fit(&str));
+                THEN("capacity equals length")
+                {
+                    CHECK(str_str_cap(&str) == 100);
+                    CHECK(ref == str_str_ptr(&str));
+                }
+            }
+
+            AND_WHEN("shrunk after truncation")
+            {
+                str_str_set_empty(&str);
+                REQUIRE(str_str_cat(&str, str_ref(ref.data(), STR_SSO_CAP)));
+                REQUIRE(str_str_shrink_to_fit(&str));
+                THEN("contents move inside")
+                {
+                    CHECK(str_str_cap(&str) == (int)STR_SSO_CAP);
+                    CHECK((void*)str_str_ptr(&str) == (void*)&str);
+                    CHECK(std::string(STR_SSO_CAP, 'x') == str_str_ptr(&str));
+                }
+            }
+        }
+
+        str_str_kill(&str);
+    }
+
+    GIVEN("const string")
+    {
+        StrStr str;
+        str_str_init_const(&str, str_ref(ref.data(), ref.size()));
+
+        WHEN("reserved")
+        {
+            REQUIRE(str_str_reserve(&str, 10));
+            THEN("contents are copied")
+            {
+                CHECK(str_str_is_mutable(&str));
+                CHECK(str_str_cap(&str) == 100);
+                CHECK(str_str_ptr(&str) != ref.data());
+                CHECK(ref == str_str_ptr(&str));
+            }
+        }
+
+        WHEN("reserved zero")
+        {
+            REQUIRE(str_str_reserve(&str, 0));
+            THEN("contents are copied")
+            {
+                CHECK(str_str_is_mutable(&str));
+                CHECK(str_str_ptr(&str) != ref.data());
+                CHECK(ref == str_str_ptr(&str));
+            }
+        }
+
+        WHEN("shrunk")
+        {
+            REQUIRE(str_str_shrink_to_fit(&str));
+            THEN("it is unchanged")
+                CHECK(str_str_ptr(&str) == ref.data());
+        }
+
+        str_str_kill(&str);
+    }
 }
@@ -0,0 +1,67 @@
+#ifndef LIBSTR_ALLOC_H_INCLUDED
+#define LIBSTR_ALLOC_H_INCLUDED
+
+#include <str/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+struct StrAlloc_s;
+typedef struct StrAlloc_s StrAlloc;
+
+// -- Selection --
+
+StrAlloc const * str_alloc_default(void)
+    __attribute__((const, returns_nonnull));
+StrAlloc const * str_alloc_get(void)
+    __attribute__((returns_nonnull));
+StrAlloc const * str_alloc_set_global(StrAlloc const * alloc);
+StrAlloc const * str_alloc_set_thread(StrAlloc const * alloc);
+
+// -- Heap blocks --
+
+char * str_heap_alloc(StrAlloc const * alloc, size_t size)
+    __attribute__((nonnull, malloc));
+char * str_heap_realloc(char * ptr, size_t old_size, size_t size)
+    __attribute__((nonnull));
+void str_heap_free(char * ptr, size_t size);
+
+// -- Implementation --
+
+/** \brief Allocator interface.
+ *
+ * Used for all heap memory owned by strings. Sizes are always passed,
+ * so size-class aware allocators don't have to store them.
+ *
+ * alloc - returns block of size bytes aligned at least to 4 or NULL
+ * realloc - optional, like realloc, NULL = alloc+copy+free
+ * free - releases block of given size
+ * - NULL = memory is owned by the allocator and released in bulk (arena)
+ * - strings from such allocator are weak, str_str_kill does nothing
+ * - realloc then only extends blocks in place, NULL otherwise
+ * ctx - user context passed to all functions
+ */
+struct StrAlloc_s
+{
+    void * (*alloc)(void * ctx, size_t size);
+    void * (*realloc)(void * ctx, void * ptr, size_t old_size, size_t size);
+    void (*free)(void * ctx, void * ptr, size_t size);
+    void * ctx;
+};
+
+/** \brief Tag bit of heap pointers with allocator header.
+ *
+ * Heap blocks are at least 4B aligned, so low bits of pointers are free.
+ * Blocks from non-default allocators carry the allocator in a header
+ * in front of the data and the returned pointer has this bit set.
+ */
+#define STR_HEAP_CARRY 0x1u
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//LIBSTR_ALLOC_H_INCLUDED
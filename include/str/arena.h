@@ -0,0 +1,87 @@
+#ifndef LIBSTR_ARENA_H_INCLUDED
+#define LIBSTR_ARENA_H_INCLUDED
+
+#include <str/api.h>
+#include <str/alloc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+struct StrArena_s;
+typedef struct StrArena_s StrArena;
+
+struct StrArenaMark_s;
+typedef struct StrArenaMark_s StrArenaMark;
+
+// -- Initialization --
+
+void str_arena_init(StrArena * arena, size_t chunk)
+    __attribute__((nonnull));
+void str_arena_kill(StrArena * arena)
+    __attribute__((nonnull));
+
+// -- Allocation --
+
+void * str_arena_alloc(StrArena * arena, size_t size)
+    __attribute__((nonnull, malloc));
+inline StrAlloc const * str_arena_allocator(StrArena * arena)
+    __attribute__((nonnull, returns_nonnull));
+
+// -- Release --
+
+StrArenaMark str_arena_mark(StrArena const * arena)
+    __attribute__((nonnull));
+void str_arena_rewind(StrArena * arena, StrArenaMark mark)
+    __attribute__((nonnull));
+void str_arena_reset(StrArena * arena)
+    __attribute__((nonnull));
+size_t str_arena_size(StrArena const * arena)
+    __attribute__((nonnull, pure));
+
+// -- Implementation --
+
+struct StrArenaChunk_s;
+
+/** \brief Bump pointer allocator.
+ *
+ * Memory is taken from chunks and released all at once.
+ * Strings allocated through str_arena_allocator are weak (STR_TAG_REF),
+ * str_str_kill on them does nothing and they die with the arena.
+ */
+struct StrArena_s
+{
+    StrAlloc alloc; // allocator interface, ctx == arena
+    struct StrArenaChunk_s * chunk; // current chunk, chunks are linked to older ones
+    char * top; // first free byte in current chunk
+    char * end; // end of current chunk
+    size_t size; // default chunk size
+};
+
+/** \brief Arena state to rewind to.
+ */
+struct StrArenaMark_s
+{
+    struct StrArenaChunk_s * chunk;
+    char * top;
+};
+
+/** \brief Allocator interface of the arena.
+ *
+ * StrAlloc const * old = str_alloc_set_thread(str_arena_allocator(&arena));
+ * ... // handle request, strings are allocated in arena
+ * str_alloc_set_thread(old);
+ * str_arena_reset(&arena); // release all strings at once
+ */
+inline StrAlloc const * str_arena_allocator(StrArena * arena)
+{
+    return &arena->alloc;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//LIBSTR_ARENA_H_INCLUDED
@@ -0,0 +1,117 @@
+#ifndef LIBSTR_ASCII_H_INCLUDED
+#define LIBSTR_ASCII_H_INCLUDED
+
+#include <str/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** \brief Character classes, independent of locale.
+ *
+ * Same as <ctype.h> in the "C" locale, bytes >= 0x80 belong to no class.
+ */
+enum StrAsciiClass_e
+{
+    STR_ASCII_SPACE = 0x01, // ' ' '\t' '\n' '\v' '\f' '\r'
+    STR_ASCII_DIGIT = 0x02,
+    STR_ASCII_UPPER = 0x04,
+    STR_ASCII_LOWER = 0x08,
+    STR_ASCII_XDIGIT = 0x10, // 0-9 A-F a-f
+    STR_ASCII_PUNCT = 0x20,
+    STR_ASCII_CNTRL = 0x40,
+
+    STR_ASCII_ALPHA = STR_ASCII_UPPER | STR_ASCII_LOWER,
+    STR_ASCII_ALNUM = STR_ASCII_ALPHA | STR_ASCII_DIGIT,
+};
+
+/** \brief Classes of all bytes, indexed by unsigned char.
+ */
+extern uint8_t const str_ascii_class[256];
+
+// -- Queries --
+
+inline bool str_ascii_is(char c, unsigned cls)
+    __attribute__((const));
+inline bool str_ascii_is_space(char c)
+    __attribute__((const));
+inline bool str_ascii_is_digit(char c)
+    __attribute__((const));
+inline bool str_ascii_is_alpha(char c)
+    __attribute__((const));
+inline bool str_ascii_is_alnum(char c)
+    __attribute__((const));
+inline bool str_ascii_is_xdigit(char c)
+    __attribute__((const));
+
+bool str_ascii_cmp_eq_ci_n(char const * a, char const * b, size_t len)
+    __attribute__((pure));
+int str_ascii_cmp_ci_n(char const * a, char const * b, size_t len)
+    __attribute__((pure));
+
+size_t str_ascii_span_space(char const * ptr, size_t len)
+    __attribute__((pure));
+size_t str_ascii_rspan_space(char const * ptr, size_t len)
+    __attribute__((pure));
+
+// -- Conversion --
+
+inline char str_ascii_tolower(char c)
+    __attribute__((const));
+inline char str_ascii_toupper(char c)
+    __attribute__((const));
+
+void str_ascii_tolower_n(char * dst, char const * src, size_t len);
+void str_ascii_toupper_n(char * dst, char const * src, size_t len);
+
+// -- Implementation --
+
+inline bool str_ascii_is(char c, unsigned cls)
+{
+    return str_ascii_class[(unsigned char)c] & cls;
+}
+
+inline bool str_ascii_is_space(char c)
+{
+    return str_ascii_is(c, STR_ASCII_SPACE);
+}
+
+inline bool str_ascii_is_digit(char c)
+{
+    return str_ascii_is(c, STR_ASCII_DIGIT);
+}
+
+inline bool str_ascii_is_alpha(char c)
+{
+    return str_ascii_is(c, STR_ASCII_ALPHA);
+}
+
+inline bool str_ascii_is_alnum(char c)
+{
+    return str_ascii_is(c, STR_ASCII_ALNUM);
+}
+
+inline bool str_ascii_is_xdigit(char c)
+{
+    return str_ascii_is(c, STR_ASCII_XDIGIT);
+}
+
+inline char str_ascii_tolower(char c)
+{
+    return str_ascii_is(c, STR_ASCII_UPPER) ? (char)(c ^ 0x20) : c;
+}
+
+inline char str_ascii_toupper(char c)
+{
+    return str_ascii_is(c, STR_ASCII_LOWER) ? (char)(c ^ 0x20) : c;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//LIBSTR_ASCII_H_INCLUDED
@@ -0,0 +1,379 @@
+#ifndef LIBSTR_BIG_H_INCLUDED
+#define LIBSTR_BIG_H_INCLUDED
+
+#include <str/api.h>
+#include <str/alloc.h>
+#include <str/ref.h>
+#include <str/str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+union StrBig_u;
+typedef union StrBig_u StrBig;
+
+// -- Initialization --
+
+inline void str_big_init_null(StrBig * big)
+    __attribute__((nonnull));
+inline void str_big_init_empty(StrBig * big)
+    __attribute__((nonnull));
+inline void str_big_init_move(StrBig * restrict dst, StrBig * restrict src)
+    __attribute__((nonnull));
+inline void str_big_init_const(StrBig * big, StrRef ref)
+    __attribute__((nonnull));
+bool str_big_init_copy(StrBig * big, StrRef ref)
+    __attribute__((nonnull));
+
+// -- Deinitialization --
+
+inline void str_big_kill(StrBig * big)
+    __attribute__((nonnull));
+
+// -- Queries --
+
+inline bool str_big_is_null(StrBig const * big)
+    __attribute__((nonnull));
+inline bool str_big_is_empty(StrBig const * big)
+    __attribute__((nonnull));
+inline bool str_big_is_mutable(StrBig const * big)
+    __attribute__((nonnull));
+
+// -- Accessors --
+
+inline size_t str_big_len(StrBig const * big)
+    __attribute__((nonnull));
+inline size_t str_big_cap(StrBig const * big)
+    __attribute__((nonnull));
+inline char const * str_big_ptr(StrBig const * big)
+    __attribute__((nonnull, returns_nonnull));
+inline char * str_big_ptr_mut(StrBig * big)
+    __attribute__((nonnull));
+inline StrRef str_big_ref(StrBig const * big)
+    __attribute__((nonnull));
+
+// -- Assignment --
+
+inline void str_big_set_null(StrBig * big)
+    __attribute__((nonnull));
+inline void str_big_set_empty(StrBig * big)
+    __attribute__((nonnull));
+inline void str_big_set_move(StrBig * restrict dst, StrBig * restrict src)
+    __attribute__((nonnull));
+inline void str_big_set_const(StrBig * big, StrRef ref)
+    __attribute__((nonnull));
+
+// -- Allocation --
+
+bool str_big_alloc(StrBig * big, size_t cap, size_t len)
+    __attribute__((nonnull));
+bool str_big_grow(StrBig * big, size_t cap)
+    __attribute__((nonnull));
+
+// -- Modifications --
+
+char const * str_big_cstr(StrBig * big)
+    __attribute__((nonnull));
+inline bool str_big_cat(StrBig * big, StrRef ref)
+    __attribute__((nonnull));
+
+// -- Implementation --
+
+/** \brief Long big string representation.
+ *
+ * Same scheme as StrRep with size_t fields, tag is in 2 msb of cap.
+ * Strong strings keep allocator flags in low bits of ptr (STR_PTR_FLAGS).
+ */
+typedef struct StrBigRep_s
+{
+    char * ptr;
+    size_t len;
+    size_t cap;
+} StrBigRep;
+
+#define STR_BIG_SSO_CAP (sizeof(StrBigRep)-1)
+#define STR_BIG_CAP_MAX (SIZE_MAX>>2)
+
+typedef struct StrBigSSO_s
+{
+    char dat[STR_BIG_SSO_CAP];
+    unsigned char len;
+} StrBigSSO;
+
+/** \brief String with size_t length.
+ *
+ * Can represent strings up to STR_BIG_CAP_MAX characters,
+ * keeps STR_BIG_SSO_CAP (23 on 64-bit) characters inside.
+ *
+ * Tags have the same meaning as for StrStr (SSO, STR, REF),
+ * big strings are never shared.
+ */
+union StrBig_u
+{
+    StrBigRep rep;
+    StrBigSSO sso;
+};
+
+#define SIZE_BIT (sizeof(size_t)*CHAR_BIT)
+
+// -- Internal functions --
+
+inline StrTag str_big_get_tag(StrBig const * big)
+    __attribute__((nonnull, pure));
+inline char const * str_big_get_ptr(StrBig const * big)
+    __attribute__((nonnull, pure));
+inline size_t str_big_get_len(StrBig const * big)
+    __attribute__((nonnull, pure));
+inline size_t str_big_get_cap(StrBig const * big)
+    __attribute__((nonnull, pure));
+inline void str_big_set_len(StrBig * big, size_t len)
+    __attribute__((nonnull));
+inline void str_big_set_tag_len_cap(StrBig * big, StrTag tag, size_t len, size_t cap)
+    __attribute__((nonnull));
+
+inline StrTag str_big_get_tag(StrBig const * big)
+{
+    // uses sso structure even for long strings
+    return (StrTag)(big->sso.len>>(CHAR_BIT-2));
+}
+
+inline size_t str_big_get_len(StrBig const * big)
+{
+    return str_big_get_tag(big) == STR_TAG_SSO
+        ? STR_BIG_SSO_CAP - big->sso.len
+        : big->rep.len;
+}
+
+inline size_t str_big_get_cap(StrBig const * big)
+{
+    return str_big_get_tag(big) == STR_TAG_SSO
+        ? STR_BIG_SSO_CAP
+        : big->rep.cap & STR_BIG_CAP_MAX;
+}
+
+inline char const * str_big_get_ptr(StrBig const * big)
+{
+    StrTag const tag = str_big_get_tag(big);
+    return tag == STR_TAG_SSO ? big->sso.dat
+        : tag == STR_TAG_STR ? (char *)((uintptr_t)big->rep.ptr & ~STR_PTR_FLAGS)
+        : big->rep.ptr;
+}
+
+#define STR_BIG_ASSERT(p) do { assert((p));                                    \
+    assert(str_big_get_tag(p) != STR_TAG_SHR);                                 \
+    if(str_big_get_ptr(p)) {                                                   \
+        if(str_big_get_cap(p) != 0) {                                          \
+            assert(str_big_get_len(p) <= str_big_get_cap(p));                  \
+            assert(str_big_get_ptr(p)[str_big_get_len(p)] == '\0'); } }        \
+    else { assert(str_big_get_len(p) == 0); assert(str_big_get_cap(p) == 0); } \
+} while(false)
+
+inline void str_big_set_len(StrBig * big, size_t len)
+{
+    assert((str_big_get_cap(big) == 0) || (len <= str_big_get_cap(big)));
+    if(str_big_get_tag(big) == STR_TAG_SSO)
+        big->sso.len = STR_BIG_SSO_CAP - len;
+    else
+        big->rep.len = len;
+    // postcondition check
+    assert(str_big_get_len(big) == len);
+}
+
+inline void str_big_set_tag_len_cap(StrBig * big, StrTag tag, size_t len, size_t cap)
+{
+    assert((tag == STR_TAG_STR) || (tag == STR_TAG_REF));
+    assert(cap <= STR_BIG_CAP_MAX);
+    assert((cap == 0) || (len <= cap));
+    big->rep.len = len;
+    big->rep.cap = cap | ((size_t)tag<<(SIZE_BIT-2));
+    // postcondition check
+    assert(str_big_get_tag(big) == tag);
+    assert(str_big_get_len(big) == len);
+    assert(str_big_get_cap(big) == cap);
+}
+
+// -- Construction --
+
+inline void str_big_init_null(StrBig * big)
+{
+    // weak reference with NULL pointer
+    memset(big, 0, sizeof(StrBig));
+    big->sso.len = STR_TAG_REF<<(CHAR_BIT-2);
+    // postcondition check
+    assert(str_big_is_null(big));// PRE big ok
+}
+
+inline void str_big_init_empty(StrBig * big)
+{
+    // short string
+    memset(big->sso.dat, 0, sizeof(StrBig));
+    big->sso.len = STR_BIG_SSO_CAP; // set len=0
+    // postcondition check
+    assert(str_big_is_empty(big));// PRE big ok
+}
+
+inline void str_big_init_move(StrBig * restrict dst, StrBig * restrict src)
+{
+    STR_BIG_ASSERT(src);
+    if(dst != src) // prevent self move
+    {
+        memcpy(dst, src, sizeof(StrBig));
+        str_big_init_null(src);// POST src null
+    }
+}
+
+/** \brief Initialize as weak constant reference.
+ *
+ * The referenced memory (e.g. mmapped file) must outlive the string,
+ * there is no length limit besides STR_BIG_CAP_MAX.
+ */
+inline void str_big_init_const(StrBig * big, StrRef ref)
+{
+    STR_REF_ASSERT(&ref);
+    if(ref.len > STR_BIG_CAP_MAX)
+    {
+        str_big_init_null(big);
+        return;
+    }
+    big->rep.ptr = (char*)ref.ptr;
+    str_big_set_tag_len_cap(big, STR_TAG_REF, ref.len, 0);
+    // postcondition check
+    STR_BIG_ASSERT(big);
+}
+
+// -- Destruction --
+
+inline void str_big_kill(StrBig * big)
+{
+    STR_BIG_ASSERT(big);
+    // the block knows its allocator
+    if(str_big_get_tag(big) == STR_TAG_STR)
+        str_heap_free(big->rep.ptr, str_big_get_cap(big)+1);
+}
+
+// -- Queries --
+
+inline bool str_big_is_null(StrBig const * big)
+{
+    STR_BIG_ASSERT(big);
+    return !str_big_get_ptr(big);
+}
+
+inline bool str_big_is_empty(StrBig const * big)
+{
+    STR_BIG_ASSERT(big);
+    return str_big_get_len(big) == 0;
+}
+
+inline bool str_big_is_mutable(StrBig const * big)
+{
+    STR_BIG_ASSERT(big);
+    return str_big_get_cap(big) > 0;
+}
+
+// -- Accessors --
+
+inline size_t str_big_len(StrBig const * big)
+{
+    STR_BIG_ASSERT(big);
+    return str_big_get_len(big);
+}
+
+inline size_t str_big_cap(StrBig const * big)
+{
+    STR_BIG_ASSERT(big);
+    return str_big_get_cap(big);
+}
+
+/** \brief Get string data pointer.
+ *
+ * \return nonnull pointer even for null string.
+ */
+inline char const * str_big_ptr(StrBig const * big)
+{
+    STR_BIG_ASSERT(big);
+    char const * ptr = str_big_get_ptr(big);
+    return ptr ? ptr : "";
+}
+
+/** \brief Get string data pointer if the contents are mutable.
+ *
+ * \return NULL for immutable contents
+ */
+inline char * str_big_ptr_mut(StrBig * big)
+{
+    return str_big_is_mutable(big)// PRE big ok
+        ? (char *)str_big_get_ptr(big) : NULL;
+}
+
+inline StrRef str_big_ref(StrBig const * big)
+{
+    STR_BIG_ASSERT(big);
+    return str_ref(str_big_get_ptr(big), str_big_get_len(big));
+}
+
+// -- Assignment --
+
+inline void str_big_set_null(StrBig * big)
+{
+    str_big_kill(big);// PRE big ok
+    str_big_init_null(big);// POST big ok
+}
+
+inline void str_big_set_empty(StrBig * big)
+{
+    if(str_big_is_mutable(big))// PRE big ok
+        str_big_ptr_mut(big)[0] = '\0';
+    str_big_set_len(big, 0);
+}
+
+inline void str_big_set_move(StrBig * restrict dst, StrBig * restrict src)
+{
+    if(dst != src)
+    {
+        str_big_kill(dst);
+        str_big_init_move(dst, src);
+    }
+}
+
+inline void str_big_set_const(StrBig * big, StrRef ref)
+{
+    str_big_kill(big);
+    str_big_init_const(big, ref);
+}
+
+// -- Modifications --
+
+inline bool str_big_cat(StrBig * big, StrRef ref)
+{
+    size_t const big_len = str_big_len(big);// PRE big ok
+    STR_REF_ASSERT(&ref);
+    if(ref.len == 0) // nothing to append, don't touch storage
+        return true;
+    // big->len + ref.len <= STR_BIG_CAP_MAX, so the sum doesn't overflow
+    // - grow only if current capacity is too small (cap > 0 -> mutable)
+    bool const ok = (ref.len <= STR_BIG_CAP_MAX-big_len)
+        && ((big_len+ref.len <= str_big_get_cap(big))
+            || str_big_grow(big, big_len+ref.len));
+    char * ptr = ok ? str_big_ptr_mut(big) : NULL;
+    if(ptr)
+    {
+        memcpy(ptr+big_len, ref.ptr, ref.len);
+        ptr[big_len+ref.len] = '\0';
+        str_big_set_len(big, big_len+ref.len);
+    }
+    return ptr != NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//LIBSTR_BIG_H_INCLUDED
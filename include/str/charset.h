@@ -0,0 +1,111 @@
+#ifndef LIBSTR_CHARSET_H_INCLUDED
+#define LIBSTR_CHARSET_H_INCLUDED
+
+#include <str/api.h>
+#include <str/ref.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct StrCharSet_s;
+typedef struct StrCharSet_s StrCharSet;
+
+struct StrSplit_s;
+typedef struct StrSplit_s StrSplit;
+
+// -- Construction --
+
+void str_charset_init(StrCharSet * set, StrRef chars)
+    __attribute__((nonnull(1)));
+
+// -- Queries --
+
+inline bool str_charset_has(StrCharSet const * set, char c)
+    __attribute__((nonnull, pure));
+
+// -- Decomposition --
+
+size_t str_ref_find_any(StrRef ref, StrCharSet const * set)
+    __attribute__((nonnull, pure));
+StrRef str_ref_word_any(StrRef * ref, StrCharSet const * set)
+    __attribute__((nonnull));
+size_t str_ref_split_any(StrRef * ref, StrCharSet const * set, StrRef * out, size_t cnt)
+    __attribute__((nonnull(1, 2)));
+
+inline void str_split_init(StrSplit * split, StrRef ref, StrCharSet const * set)
+    __attribute__((nonnull(1, 3)));
+inline bool str_split_next(StrSplit * split, StrRef * field)
+    __attribute__((nonnull));
+
+// -- Implementation --
+
+/** \brief Set of bytes, built once and used for many scans.
+ *
+ * Nibble tables serve vectorized lookup of ASCII members,
+ * the bitmap serves scalar code and sets with non-ASCII bytes.
+ */
+struct StrCharSet_s
+{
+    uint8_t lo[16]; // by low nibble : bit n set if (n<<4 | low nibble) is member, n < 8
+    uint8_t hi[16]; // by high nibble : 1<<high nibble, 0 for non-ASCII
+    uint64_t bit[4]; // all members
+    bool ascii; // no member >= 0x80, nibble tables are complete
+};
+
+/** \brief Fields of a string separated by any byte of a set.
+ *
+ * n separators give n+1 fields, null string gives none.
+ *
+ * StrCharSet set;
+ * str_charset_init(&set, str_ref_cstr(",;\t"));
+ * StrSplit split;
+ * str_split_init(&split, line, &set);
+ * for(StrRef field; str_split_next(&split, &field); )
+ *     use(field);
+ */
+struct StrSplit_s
+{
+    StrRef rest; // null after the last field
+    StrCharSet const * set;
+};
+
+inline bool str_charset_has(StrCharSet const * set, char c)
+{
+    unsigned char const u = c;
+    return (set->bit[u>>6] >> (u & 63)) & 1;
+}
+
+inline void str_split_init(StrSplit * split, StrRef ref, StrCharSet const * set)
+{
+    STR_REF_ASSERT(&ref);
+    split->rest = ref;
+    split->set = set;
+}
+
+inline bool str_split_next(StrSplit * split, StrRef * field)
+{
+    if(!split->rest.ptr)
+        return false;
+    size_t const pos = str_ref_find_any(split->rest, split->set);
+    if(pos == SIZE_MAX)
+    {
+        *field = split->rest;
+        split->rest = str_ref_null();
+    }
+    else
+    {
+        *field = str_ref(split->rest.ptr, pos);
+        split->rest = str_ref_tail(split->rest, pos + 1);
+    }
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//LIBSTR_CHARSET_H_INCLUDED
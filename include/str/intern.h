@@ -0,0 +1,107 @@
+#ifndef LIBSTR_INTERN_H_INCLUDED
+#define LIBSTR_INTERN_H_INCLUDED
+
+#include <str/api.h>
+#include <str/arena.h>
+#include <str/ref.h>
+#include <str/str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct StrIntern_s;
+typedef struct StrIntern_s StrIntern;
+
+struct StrInternStats_s;
+typedef struct StrInternStats_s StrInternStats;
+
+// -- Initialization --
+
+void str_intern_init(StrIntern * intern)
+    __attribute__((nonnull));
+void str_intern_kill(StrIntern * intern)
+    __attribute__((nonnull));
+StrIntern * str_intern_global(void)
+    __attribute__((const, returns_nonnull));
+
+// -- Lookup --
+
+StrRef str_intern(StrIntern * intern, StrRef ref)
+    __attribute__((nonnull(1)));
+StrRef str_intern_find(StrIntern * intern, StrRef ref)
+    __attribute__((nonnull(1)));
+inline bool str_str_init_intern(StrStr * str, StrIntern * intern, StrRef ref)
+    __attribute__((nonnull(1, 2)));
+
+// -- Accounting --
+
+void str_intern_stats(StrIntern * intern, StrInternStats * stats)
+    __attribute__((nonnull));
+
+// -- Implementation --
+
+#define STR_INTERN_SHARDS 16
+
+struct StrInternTable_s;
+
+/** \brief Part of the table with its own lock and memory.
+ *
+ * Readers load the table and its slots without locking, writers
+ * serialize on the lock. Replaced tables are kept until the interner
+ * is killed, so readers never see freed memory.
+ */
+typedef struct StrInternShard_s
+{
+    struct StrInternTable_s * table; // atomic, current table
+    struct StrInternTable_s * retired; // older tables, readers may use them
+    bool lock; // atomic flag
+    size_t count; // strings
+    size_t bytes; // their contents including terminators
+    size_t table_bytes; // all tables including retired ones
+    StrArena arena; // node storage
+} __attribute__((aligned(64))) StrInternShard;
+
+/** \brief Set of canonical immutable strings.
+ *
+ * Equal contents give the same zero-terminated pointer, so interned
+ * strings are compared by pointer. Pointers are stable until the
+ * interner is killed. Lookup is lock-free, insertion locks one shard.
+ *
+ * Zero-initialized StrIntern is an empty interner too.
+ */
+struct StrIntern_s
+{
+    StrInternShard shard[STR_INTERN_SHARDS];
+};
+
+/** \brief Memory accounting.
+ */
+struct StrInternStats_s
+{
+    size_t count; // interned strings
+    size_t bytes; // their contents including terminators
+    size_t memory; // total memory held, node storage and tables
+};
+
+/** \brief Initialize as weak constant reference to interned copy of ref.
+ *
+ * The contents are zero-terminated, str_str_cstr doesn't copy them.
+ *
+ * \return false if allocation failed, str is null then.
+ */
+inline bool str_str_init_intern(StrStr * str, StrIntern * intern, StrRef ref)
+{
+    StrRef const canon = str_intern(intern, ref);
+    str_str_init_const_rterm(str, canon);
+    return canon.ptr || !ref.ptr;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//LIBSTR_INTERN_H_INCLUDED
@@ -0,0 +1,85 @@
+#ifndef LIBSTR_MAP_H_INCLUDED
+#define LIBSTR_MAP_H_INCLUDED
+
+#include <str/api.h>
+#include <str/ref.h>
+#include <str/str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct StrMap_s;
+typedef struct StrMap_s StrMap;
+
+struct StrMapSlot_s;
+typedef struct StrMapSlot_s StrMapSlot;
+
+// -- Initialization --
+
+void str_map_init(StrMap * map)
+    __attribute__((nonnull));
+void str_map_kill(StrMap * map)
+    __attribute__((nonnull));
+
+// -- Queries --
+
+inline size_t str_map_len(StrMap const * map)
+    __attribute__((nonnull, pure));
+void ** str_map_find(StrMap const * map, StrRef key)
+    __attribute__((nonnull(1)));
+StrMapSlot * str_map_next(StrMap const * map, size_t * idx)
+    __attribute__((nonnull));
+
+// -- Modifications --
+
+bool str_map_reserve(StrMap * map, size_t cnt)
+    __attribute__((nonnull));
+void ** str_map_insert(StrMap * map, StrRef key, bool * added)
+    __attribute__((nonnull(1)));
+void ** str_map_insert_move(StrMap * map, StrStr * key, bool * added)
+    __attribute__((nonnull(1, 2)));
+bool str_map_erase(StrMap * map, StrRef key, void ** val)
+    __attribute__((nonnull(1)));
+
+// -- Implementation --
+
+/** \brief Key and value stored in the table.
+ *
+ * Short keys live inside the slot, long ones are owned by it.
+ */
+struct StrMapSlot_s
+{
+    StrStr key;
+    void * val;
+};
+
+/** \brief Hash map from strings to pointers.
+ *
+ * Open addressing with linear probing and backward shift deletion.
+ * 32 bits of every hash are kept in an array parallel to the slots,
+ * probes compare them before touching the keys.
+ * Lookups take StrRef, no key string is constructed.
+ */
+struct StrMap_s
+{
+    StrMapSlot * slot;
+    uint32_t * hash; // 0 = empty slot
+    size_t mask; // slots - 1, 0 without slots
+    size_t len;
+};
+
+inline size_t str_map_len(StrMap const * map)
+{
+    return map->len;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//LIBSTR_MAP_H_INCLUDED
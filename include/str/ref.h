@@ -12,6 +12,7 @@ extern "C" {
 #include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 struct StrRef_s;
 typedef struct StrRef_s StrRef;
@@ -29,6 +30,14 @@ inline bool str_ref_is_null(StrRef ref);
 inline bool str_ref_is_empty(StrRef ref);
 
 inline bool str_ref_cmp_eq(StrRef a, StrRef b);
+inline bool str_ref_cmp_eq_ci(StrRef a, StrRef b);
+inline int str_ref_cmp(StrRef a, StrRef b);
+inline int str_ref_cmp_ci(StrRef a, StrRef b);
+
+inline bool str_ref_starts_with(StrRef ref, StrRef prefix);
+inline bool str_ref_ends_with(StrRef ref, StrRef suffix);
+inline bool str_ref_starts_with_ci(StrRef ref, StrRef prefix);
+inline bool str_ref_ends_with_ci(StrRef ref, StrRef suffix);
 
 // -- Access --
 
@@ -44,16 +53,21 @@ inline StrRef str_ref_substr(StrRef ref, size_t idx, size_t len STR_DEFAULT(SIZE
 // -- Decomposition --
 
 size_t str_ref_find_c(StrRef ref, char c);
+size_t str_ref_find(StrRef ref, StrRef sub);
+size_t str_ref_rfind(StrRef ref, StrRef sub);
 StrRef str_ref_word_c(StrRef * ref, char c)
     __attribute__((nonnull));
+size_t str_ref_split_c(StrRef * ref, char c, StrRef * out, size_t cnt)
+    __attribute__((nonnull(1)));
 
 inline StrRef str_ref_chop_spaces(StrRef ref);
 inline StrRef str_ref_trim_spaces(StrRef ref);
 
 // -- Implementation --
 
+#include <str/ascii.h>
+
 #include <assert.h>
-#include <ctype.h>
 #include <string.h>
 
 /** \brief Weak reference to character array.
@@ -120,6 +134,60 @@ inline bool str_ref_cmp_eq(StrRef a, StrRef b)
     return (a.len == b.len) && ((a.ptr == b.ptr) || (memcmp(a.ptr, b.ptr, a.len) == 0));
 }
 
+inline bool str_ref_cmp_eq_ci(StrRef a, StrRef b)
+{
+    STR_REF_ASSERT(&a);
+    STR_REF_ASSERT(&b);
+    return (a.len == b.len) && ((a.ptr == b.ptr) || str_ascii_cmp_eq_ci_n(a.ptr, b.ptr, a.len));
+}
+
+inline int str_ref_cmp(StrRef a, StrRef b)
+{
+    STR_REF_ASSERT(&a);
+    STR_REF_ASSERT(&b);
+    size_t const len = a.len < b.len ? a.len : b.len;
+    int const cmp = len ? memcmp(a.ptr, b.ptr, len) : 0;
+    return cmp ? cmp : (a.len > b.len) - (a.len < b.len);
+}
+
+inline int str_ref_cmp_ci(StrRef a, StrRef b)
+{
+    STR_REF_ASSERT(&a);
+    STR_REF_ASSERT(&b);
+    int const cmp = str_ascii_cmp_ci_n(a.ptr, b.ptr, a.len < b.len ? a.len : b.len);
+    return cmp ? cmp : (a.len > b.len) - (a.len < b.len);
+}
+
+inline bool str_ref_starts_with(StrRef ref, StrRef prefix)
+{
+    STR_REF_ASSERT(&ref);
+    STR_REF_ASSERT(&prefix);
+    return (prefix.len <= ref.len)
+        && ((prefix.len == 0) || (memcmp(ref.ptr, prefix.ptr, prefix.len) == 0));
+}
+
+inline bool str_ref_ends_with(StrRef ref, StrRef suffix)
+{
+    STR_REF_ASSERT(&ref);
+    STR_REF_ASSERT(&suffix);
+    return (suffix.len <= ref.len)
+        && ((suffix.len == 0) || (memcmp(ref.ptr + ref.len - suffix.len, suffix.ptr, suffix.len) == 0));
+}
+
+inline bool str_ref_starts_with_ci(StrRef ref, StrRef prefix)
+{
+    STR_REF_ASSERT(&ref);
+    return (prefix.len <= ref.len)
+        && str_ref_cmp_eq_ci(str_ref(ref.ptr, prefix.len), prefix);
+}
+
+inline bool str_ref_ends_with_ci(StrRef ref, StrRef suffix)
+{
+    STR_REF_ASSERT(&ref);
+    return (suffix.len <= ref.len)
+        && str_ref_cmp_eq_ci(str_ref(ref.ptr + ref.len - suffix.len, suffix.len), suffix);
+}
+
 // -- Access --
 
 inline size_t str_ref_len(StrRef ref)
@@ -165,23 +233,23 @@ inline StrRef str_ref_substr(StrRef ref, size_t idx, size_t len)
 inline StrRef str_ref_chop_spaces(StrRef ref)
 {
     STR_REF_ASSERT(&ref);
-    while((ref.len > 0) && isspace(ref.ptr[ref.len-1]))
-    {
-        --ref.len;
-    }
+    // most strings end with non-space, scan only if there is something to chop
+    if((ref.len > 0) && str_ascii_is_space(ref.ptr[ref.len-1]))
+        ref.len -= str_ascii_rspan_space(ref.ptr, ref.len);
     return ref;
-} 
+}
 
 inline StrRef str_ref_trim_spaces(StrRef ref)
 {
     STR_REF_ASSERT(&ref);
-    while((ref.len > 0) && isspace(ref.ptr[0]))
+    if((ref.len > 0) && str_ascii_is_space(ref.ptr[0]))
     {
-        ++ref.ptr;
-        --ref.len;
+        size_t const n = str_ascii_span_space(ref.ptr, ref.len);
+        ref.ptr += n;
+        ref.len -= n;
     }
     return str_ref_chop_spaces(ref);
-} 
+}
 
 #ifdef __cplusplus
 }
@@ -8,6 +8,10 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+
+#include <sys/types.h> // ssize_t
+
 inline ssize_t str_decode_b16_size(size_t len)
 {
     return len%2 == 0 ? (ssize_t)(len/2) : -1;
@@ -0,0 +1,33 @@
+#ifndef LIBSTR_REF_HASH_H_INCLUDED
+#define LIBSTR_REF_HASH_H_INCLUDED
+
+#include <str/api.h>
+#include <str/ref.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/** \brief Fast non-cryptographic hash of ref contents.
+ *
+ * wyhash, stable across runs and platforms for the same seed,
+ * words are read as little endian on all of them.
+ * Don't use with a fixed seed for keys chosen by an attacker.
+ */
+uint64_t str_ref_hash(StrRef ref, uint64_t seed)
+    __attribute__((pure));
+
+/** \brief Hash ignoring ASCII case.
+ *
+ * Equal to str_ref_hash of the contents converted to lower case.
+ */
+uint64_t str_ref_hash_ci(StrRef ref, uint64_t seed)
+    __attribute__((pure));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//LIBSTR_REF_HASH_H_INCLUDED
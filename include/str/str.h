@@ -2,6 +2,7 @@
 #define LIBSTR_STR_H_INCLUDED
 
 #include <str/api.h>
+#include <str/alloc.h>
 #include <str/ref.h>
 
 #ifdef __cplusplus
@@ -35,13 +36,22 @@ inline void str_str_init_weak(StrStr * str, char * ptr, int len, unsigned cap)
     __attribute__((nonnull(1)));
 inline void str_str_init_const(StrStr * str, StrRef ref)
     __attribute__((nonnull));
-//inline bool str_str_init_copy(StrStr * str, StrRef ref)
-//    __attribute__((nonnull));
+inline void str_str_init_const_rterm(StrStr * str, StrRef ref)
+    __attribute__((nonnull));
+inline void str_str_init_substr(StrStr * dst, StrStr const * src, size_t idx, size_t len)
+    __attribute__((nonnull));
+inline bool str_str_init_copy(StrStr * str, StrRef ref)
+    __attribute__((nonnull));
+bool str_str_init_copy_n(StrStr * dst, StrRef const * src, size_t cnt, void ** mem)
+    __attribute__((nonnull(4)));
+bool str_str_init_share(StrStr * restrict dst, StrStr * restrict src)
+    __attribute__((nonnull));
 
 // -- Deinitialization --
 
 inline void str_str_kill(StrStr * str)
     __attribute__((nonnull));
+void str_str_kill_n(StrStr * str, size_t cnt, void * mem);
 
 // -- Queries --
 
@@ -51,6 +61,8 @@ inline bool str_str_is_empty(StrStr const * str)
     __attribute__((nonnull));
 inline bool str_str_is_mutable(StrStr const * str)
     __attribute__((nonnull));
+bool str_str_is_shared(StrStr const * str)
+    __attribute__((nonnull));
 
 // -- Access --
 
@@ -79,10 +91,23 @@ inline void str_str_set_weak(StrStr * str, char * ptr, int len, unsigned cap)
     __attribute__((nonnull(1)));
 inline void str_str_set_const(StrStr * str, StrRef ref)
     __attribute__((nonnull));
+inline void str_str_set_const_rterm(StrStr * str, StrRef ref)
+    __attribute__((nonnull));
+bool str_str_set_share(StrStr * restrict dst, StrStr * restrict src)
+    __attribute__((nonnull));
 
 // -- Allocation --
 
 bool str_str_alloc(StrStr * str, int cap, int len);
+bool str_str_alloc_with(StrStr * str, StrAlloc const * alloc, int cap, int len)
+    __attribute__((nonnull));
+bool str_str_grow(StrStr * str, int cap)
+    __attribute__((nonnull));
+bool str_str_reserve(StrStr * str, int cap)
+    __attribute__((nonnull));
+bool str_str_shrink_to_fit(StrStr * str)
+    __attribute__((nonnull));
+unsigned str_str_set_growth(unsigned percent);
 
 // -- Modification --
 
@@ -90,8 +115,24 @@ inline char const * str_str_cstr(StrStr * str)
     __attribute__((nonnull));
 inline bool str_str_cat(StrStr * str, StrRef ref)
     __attribute__((nonnull));
+bool str_str_catv(StrStr * str, StrRef const * refs, size_t cnt)
+    __attribute__((nonnull(1)));
 bool str_str_fmt(StrStr * str, char const * fmt, ...)
     __attribute__((format(printf, 2, 3)));
+bool str_str_vfmt(StrStr * str, char const * fmt, va_list args)
+    __attribute__((format(printf, 2, 0)));
+bool str_str_fmt_cat(StrStr * str, char const * fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+bool str_str_vfmt_cat(StrStr * str, char const * fmt, va_list args)
+    __attribute__((format(printf, 2, 0)));
+bool str_str_fmt_stream(StrStr * str, char const * fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+bool str_str_vfmt_stream(StrStr * str, char const * fmt, va_list args)
+    __attribute__((format(printf, 2, 0)));
+bool str_str_tolower(StrStr * str)
+    __attribute__((nonnull));
+bool str_str_toupper(StrStr * str)
+    __attribute__((nonnull));
 
 // Behavior :
 //
@@ -118,9 +159,10 @@ bool str_str_fmt(StrStr * str, char const * fmt, ...)
 // - data lifetime is programmers concern in case of weak strings
 // - strong strings are always zero-term
 // -- allocates cap+1 bytes
-// - weak strings are ?-term (what here?)
-// -- cap == 0 (reference to literal-like stuff), read flag is in tag
+// - weak strings are ?-term
+// -- cap == 0 (reference to literal-like stuff), read flag is msb of len
 // -- cap >  0 -> zero-term (must point to array of cap+1 bytes)
+// -- msb of len is not part of capacity, so it is limited to 30 bits
 //
 
 
@@ -194,21 +236,44 @@ typedef enum StrTag_e
 {
     STR_TAG_SSO = 0x0,// short strong string (ShortStringOptimization)
     STR_TAG_STR = 0x2,// long strong string (ptr != null, len <= cap > 0)
-    STR_TAG_REF = 0x1 // long weak string (cap == 0)
-    // TODO REF with readable ptr[len]
-    //STR_TAG_??? = 0x3 unused for now
+    STR_TAG_REF = 0x1,// long weak string (cap == 0 or cap <= STR_REF_CAP_MAX)
+    STR_TAG_SHR = 0x3 // long shared string (refcounted block, copy on write)
 } StrTag;
 
+/** \brief Size of StrStr in bytes, selected at compile time.
+ *
+ * 16 (default on 64-bit), 24 or 32 give 15, 23 or 31 characters
+ * of short string capacity, e.g. UUIDs fit into 32 byte strings.
+ * The library and its users must be compiled with the same value.
+ */
+#ifndef STR_STR_SIZE
+#define STR_STR_SIZE (__SIZEOF_POINTER__ + 2*__SIZEOF_INT__)
+#endif
+
+#define STR_REP_EXT (STR_STR_SIZE - __SIZEOF_POINTER__ - 2*__SIZEOF_INT__)
+
 /** \brief Long string representation.
+ *
+ * Shared strings point after a header with reference count and allocator.
+ *
+ * Strong and shared strings keep flags in low bits of ptr (heap blocks are aligned) :
+ * - bit 0 : block carries its allocator (STR_HEAP_CARRY)
+ * - bit 1 : contents are known not to contain '\0' (STR_PTR_NUL_FREE)
  */
 typedef struct StrRep_s
 {
+#if STR_REP_EXT > 0
+    char ext[STR_REP_EXT];// only extends short string capacity
+#endif
     char * ptr;
     unsigned len;
     unsigned cap;
 } StrRep;
 
 #define STR_SSO_CAP (sizeof(StrRep)-1)
+#define STR_REF_CAP_MAX (INT_MAX>>1)
+#define STR_PTR_FLAGS ((uintptr_t)0x3)
+#define STR_PTR_NUL_FREE ((uintptr_t)0x2)
 
 typedef struct StrSSO_s
 {
@@ -226,6 +291,10 @@ typedef union StrStr_u
     StrSSO sso;
 } StrStr;
 
+// short length and tag share one byte
+static_assert(sizeof(StrStr) == STR_STR_SIZE, "STR_STR_SIZE must be a multiple of pointer size");
+static_assert(STR_SSO_CAP <= (UCHAR_MAX>>2), "STR_STR_SIZE is too large");
+
 #define INT_BIT (sizeof(int)*CHAR_BIT)
 
 // -- Internal functions --
@@ -246,6 +315,20 @@ inline void str_str_set_tag_len_cap(StrStr * str, StrTag tag, int len, int cap)
     __attribute__((nonnull));
 inline void str_str_set_len_cap(StrStr * str, int len, int cap)
     __attribute__((nonnull));
+inline bool str_str_get_rterm(StrStr const * str)
+    __attribute__((nonnull, pure));
+inline void str_str_set_rterm(StrStr * str)
+    __attribute__((nonnull));
+inline bool str_str_get_nul_free(StrStr const * str)
+    __attribute__((nonnull, pure));
+inline void str_str_set_nul_free(StrStr * str, bool nul_free)
+    __attribute__((nonnull));
+inline char * str_str_get_heap(StrStr const * str)
+    __attribute__((nonnull, pure));
+void str_str_release(StrStr * str)
+    __attribute__((nonnull));
+char * str_str_unshare(StrStr * str)
+    __attribute__((nonnull));
 
 inline StrTag str_str_get_tag(StrStr const * str)
 {
@@ -263,15 +346,40 @@ inline int str_str_get_len(StrStr const * str)
 inline int str_str_get_cap(StrStr const * str)
 {
     // 2nd msb of cap is stored as msb of len
-    return str_str_get_tag(str) == STR_TAG_SSO
-        ? STR_SSO_CAP
+    // - except weak strings, where it is readable terminator flag
+    StrTag const tag = str_str_get_tag(str);
+    return tag == STR_TAG_SSO ? STR_SSO_CAP
+        : tag == STR_TAG_REF ? str->rep.cap & (INT_MAX>>1)
         : (str->rep.cap & (INT_MAX>>1)) | ((str->rep.len & (INT_MAX+1u))>>1);
 }
 
+/** \brief Is ptr[len] readable?
+ *
+ * True for zero-term and read-term strings.
+ */
+inline bool str_str_get_rterm(StrStr const * str)
+{
+    // only const weak strings (cap == 0) may have inaccessible terminator
+    return (str_str_get_tag(str) != STR_TAG_REF)
+        || (str->rep.cap & (INT_MAX>>1))
+        || (str->rep.len & (INT_MAX+1u));
+}
+
 inline char const * str_str_get_ptr(StrStr const * str)
 {
-    return str_str_get_tag(str) == STR_TAG_SSO
-        ? str->sso.dat : str->rep.ptr;
+    StrTag const tag = str_str_get_tag(str);
+    // STR and SHR have the msb of tag set
+    return tag == STR_TAG_SSO ? str->sso.dat
+        : tag & STR_TAG_STR ? (char *)((uintptr_t)str->rep.ptr & ~STR_PTR_FLAGS)
+        : str->rep.ptr;
+}
+
+/** \brief Heap block pointer of strong string, as returned by str_heap_alloc.
+ */
+inline char * str_str_get_heap(StrStr const * str)
+{
+    assert(str_str_get_tag(str) == STR_TAG_STR);
+    return (char *)((uintptr_t)str->rep.ptr & ~STR_PTR_NUL_FREE);
 }
 
 #define STR_STR_ASSERT(p) do { assert((p));                                    \
@@ -284,7 +392,7 @@ inline char const * str_str_get_ptr(StrStr const * str)
 
 inline void str_str_set_tag(StrStr * str, StrTag tag)
 {
-    assert(((int)tag >= 0) && ((int)tag <= 2));
+    assert(((int)tag >= 0) && ((int)tag <= 3));
     // Uses sso structure even for long strings
     str->sso.len = (tag<<(CHAR_BIT-2)) | (str->sso.len&(UCHAR_MAX>>2));
     // postcondition check
@@ -305,9 +413,10 @@ inline void str_str_set_len(StrStr * str, int len)
 
 inline void str_str_set_tag_len_cap(StrStr * str, StrTag tag, int len, int cap)
 {
-    assert((tag == STR_TAG_STR) || (tag == STR_TAG_REF));
+    assert(tag != STR_TAG_SSO);
     assert(len >= 0); assert(cap >= 0);
     assert((cap == 0) || (len <= cap));
+    assert((tag != STR_TAG_REF) || (cap <= STR_REF_CAP_MAX));
     str->rep.len = len | ((cap<<1) & (INT_MAX+1u));
     str->rep.cap = (cap & (INT_MAX>>1)) | (tag<<(INT_BIT-2));
     // postcondition check
@@ -321,6 +430,38 @@ inline void str_str_set_len_cap(StrStr * str, int len, int cap)
     str_str_set_tag_len_cap(str, str_str_get_tag(str), len, cap);
 }
 
+/** \brief Mark const weak string as read-term.
+ */
+inline void str_str_set_rterm(StrStr * str)
+{
+    assert(str_str_get_tag(str) == STR_TAG_REF);
+    assert(str_str_get_cap(str) == 0);
+    str->rep.len |= INT_MAX+1u;
+    // postcondition check
+    assert(str_str_get_rterm(str));
+}
+
+/** \brief Are contents known not to contain '\0'?
+ *
+ * Cached by str_str_cstr for owned long strings,
+ * any access to mutable contents clears it.
+ */
+inline bool str_str_get_nul_free(StrStr const * str)
+{
+    return (str_str_get_tag(str) & STR_TAG_STR)
+        && ((uintptr_t)str->rep.ptr & STR_PTR_NUL_FREE);
+}
+
+inline void str_str_set_nul_free(StrStr * str, bool nul_free)
+{
+    // short and weak strings don't cache it
+    // - weak contents may be changed by their owner
+    if(str_str_get_tag(str) & STR_TAG_STR)
+        str->rep.ptr = (char *)(nul_free
+            ? (uintptr_t)str->rep.ptr | STR_PTR_NUL_FREE
+            : (uintptr_t)str->rep.ptr & ~STR_PTR_NUL_FREE);
+}
+
 // -- Construction --
 
 inline void str_str_init_null(StrStr * str)
@@ -362,6 +503,7 @@ inline void str_str_init_weak(StrStr * str, char * ptr, int len, unsigned cap)
     assert(ptr || (len == 0)); // !ptr implies len==0
     assert(cap <= (INT_MAX+1u)); // 
     // count characters if len is negative
+    bool rterm = cap > 0;
     if(len < 0)
     {
         size_t size = strlen(ptr);
@@ -372,6 +514,7 @@ inline void str_str_init_weak(StrStr * str, char * ptr, int len, unsigned cap)
         }
         len = size;
         // surely zero-term
+        rterm = true;
     }
     assert(len >= 0);
     // zero terminate if mutable
@@ -381,9 +524,13 @@ inline void str_str_init_weak(StrStr * str, char * ptr, int len, unsigned cap)
         ptr[len] = '\0';
         --cap; // keep one byte for terminator
         // surely zero-term
+        if(cap > STR_REF_CAP_MAX) // weak capacity has 30 bits
+            cap = len <= STR_REF_CAP_MAX ? STR_REF_CAP_MAX : 0;
     }
     str->rep.ptr = ptr;
     str_str_set_tag_len_cap(str, STR_TAG_REF, len, cap);
+    if(rterm && (cap == 0))
+        str_str_set_rterm(str);
     // postcondition check
     STR_STR_ASSERT(str);
 }
@@ -403,14 +550,75 @@ inline void str_str_init_const(StrStr * str, StrRef ref)
     }
 }
 
+/** \brief Initialize as weak constant reference with readable ref.ptr[ref.len].
+ *
+ * E.g. reference into zero terminated buffer or to a part of larger buffer,
+ * str_str_cstr then needs no copy if the terminator happens to be zero.
+ */
+inline void str_str_init_const_rterm(StrStr * str, StrRef ref)
+{
+    str_str_init_const(str, ref);
+    if(ref.ptr && (ref.len <= INT_MAX))
+        str_str_set_rterm(str);
+}
+
+/** \brief Initialize as weak constant reference to part of src.
+ *
+ * The part is read-term if src is or if it doesn't reach the end of src.
+ * It references internal buffer of short strings, src must not be
+ * modified, moved or killed while dst is used.
+ */
+inline void str_str_init_substr(StrStr * dst, StrStr const * src, size_t idx, size_t len)
+{
+    StrRef const ref = str_ref_substr(str_str_ref(src), idx, len);// PRE src ok
+    if(str_str_get_rterm(src) || (ref.ptr + ref.len < str_str_get_ptr(src) + str_str_get_len(src)))
+        str_str_init_const_rterm(dst, ref);
+    else
+        str_str_init_const(dst, ref);
+}
+
 /** \brief Initialize string by copy of ref.
  *
- * \return false if ref is too big or allocation failed.
+ * Short contents are stored inside, long ones get exactly len+1 bytes
+ * from the current allocator. Null ref gives null string.
+ *
+ * \return false if ref is too big or allocation failed, str is null then.
  */
-//inline bool str_str_init_copy(StrStr * str, StrRef ref)
-//{
-//    return false;
-//}
+inline bool str_str_init_copy(StrStr * str, StrRef ref)
+{
+    STR_REF_ASSERT(&ref);
+    if(!ref.ptr)
+    {
+        str_str_init_null(str);
+        return true;
+    }
+    if(ref.len <= STR_SSO_CAP)
+    {
+        memcpy(str->sso.dat, ref.ptr, ref.len);
+        // for full string, terminator is the length byte
+        ((char*)str)[ref.len] = '\0';
+        str->sso.len = STR_SSO_CAP - ref.len;
+    }
+    else
+    {
+        StrAlloc const * alloc = str_alloc_get();
+        // allocator without free owns the memory, string will be weak
+        size_t const max = alloc->free ? INT_MAX : STR_REF_CAP_MAX;
+        char * ptr = ref.len <= max ? str_heap_alloc(alloc, ref.len+1) : NULL;
+        if(!ptr)
+        {
+            str_str_init_null(str);
+            return false;
+        }
+        char * dat = (char*)((uintptr_t)ptr & ~STR_PTR_FLAGS);
+        memcpy(dat, ref.ptr, ref.len);
+        dat[ref.len] = '\0';
+        str->rep.ptr = ptr;
+        str_str_set_tag_len_cap(str, alloc->free ? STR_TAG_STR : STR_TAG_REF, ref.len, ref.len);
+    }
+    STR_STR_ASSERT(str);
+    return true;
+}
 
 // -- Queries
 
@@ -459,12 +667,19 @@ inline char const * str_str_ptr(StrStr const * str)
 
 /** \brief Get string data pointer if the contents are mutable.
  *
- * \return NULL for immutable contents
+ * Shared contents are copied first if there are other owners.
+ * Cached state of the contents (see str_str_cstr) is dropped.
+ *
+ * \return NULL for immutable contents or if copying failed
  */
 inline char * str_str_ptr_mut(StrStr * str)
 {
-    return str_str_is_mutable(str)// PRE str ok
-        ? (char *)str_str_get_ptr(str) : NULL;
+    if(!str_str_is_mutable(str))// PRE str ok
+        return NULL;
+    char * ptr = str_str_get_tag(str) == STR_TAG_SHR
+        ? str_str_unshare(str) : (char *)str_str_get_ptr(str);
+    str_str_set_nul_free(str, false);
+    return ptr;
 }
 
 inline StrRef str_str_ref(StrStr const * str)
@@ -480,8 +695,11 @@ inline void str_str_kill(StrStr * str)
 {
     STR_STR_ASSERT(str);
     // free data if long strong string
+    // - the block knows its allocator
     if(str_str_get_tag(str) == STR_TAG_STR)
-        free(str->rep.ptr);
+        str_heap_free(str_str_get_heap(str), str_str_get_cap(str)+1u);
+    else if(str_str_get_tag(str) == STR_TAG_SHR)
+        str_str_release(str);
 }
 
 inline void str_str_set_null(StrStr * str)
@@ -492,6 +710,13 @@ inline void str_str_set_null(StrStr * str)
 
 inline void str_str_set_empty(StrStr * str)
 {
+    if(str_str_get_tag(str) == STR_TAG_SHR)
+    {
+        // don't copy contents just to drop them
+        str_str_kill(str);// PRE str ok
+        str_str_init_empty(str);
+        return;
+    }
     if(str_str_is_mutable(str))// PRE str ok
         str_str_ptr_mut(str)[0] = '\0';
     str_str_set_len(str, 0);// POST len == x
@@ -518,13 +743,21 @@ inline void str_str_set_const(StrStr * str, StrRef ref)
     str_str_init_const(str, ref);
 }
 
+inline void str_str_set_const_rterm(StrStr * str, StrRef ref)
+{
+    str_str_kill(str);
+    str_str_init_const_rterm(str, ref);
+}
+
 // -- Modifications --
 
 /** \brief Get pointer to zero-terminated string contents.
  *
  * The function ensures ptr[0..len-1] != '\0' and ptr[len] == '\0'
  *
- * O(N) If this is an issue, cstrings are bad idea anyway.
+ * O(N) for the first call, long owned strings remember the result
+ * until str_str_ptr_mut is called again, pointers obtained from it
+ * before must not be used to write '\0' into the contents.
  *
  * \return NULL if string contains '\0' or reallocation fails.
  */
@@ -532,36 +765,57 @@ inline char const * str_str_cstr(StrStr * str)
 {
     int const str_len = str_str_len(str);// PRE str ok
     char const * ptr = str_str_get_ptr(str);
-    // if not null-terminated, reallocate
-    bool ok = ptr && (ptr[str_len] == '\0');
+    if(str_str_get_nul_free(str)) // checked already, owned strings are zero-term
+        return ptr;
+    // if not null-terminated or terminator is unreadable, reallocate
+    bool ok = ptr && str_str_get_rterm(str) && (ptr[str_len] == '\0');
     if(!ok)
     {
         ok = str_str_alloc(str, -1, str_len);// puts zero-term
         ptr = str_str_get_ptr(str);
     }
     // ensure string does not contain '\0'
-    return ok && !memchr(ptr, '\0', str_len) ? ptr : NULL;
+    if(!ok || memchr(ptr, '\0', str_len))
+        return NULL;
+    str_str_set_nul_free(str, true);
+    return ptr;
 }
 
 inline bool str_str_cat(StrStr * str, StrRef ref)
 {
     int const str_len = str_str_len(str);// PRE str ok
     STR_REF_ASSERT(&ref);
+    if(ref.len == 0) // nothing to append, don't touch storage
+        return true;
     // str->len + ref.len <= INT_MAX (0 <= str->len <= INT_MAX)
+    // - grow only if current capacity is too small (cap > 0 -> mutable)
     bool const ok = (ref.len <= (size_t)(INT_MAX-str_len))
-        && str_str_alloc(str, str_len+ref.len, INT_MAX);
-    if(ok)
+        && (((int)ref.len <= str_str_get_cap(str)-str_len)
+            || str_str_grow(str, str_len+ref.len));
+    // shared contents are copied here
+    char * ptr = ok ? str_str_ptr_mut(str) : NULL;
+    if(ptr)
     {
-        char * ptr = str_str_ptr_mut(str);
         memcpy(ptr+str_len, ref.ptr, ref.len);
         ptr[str_len+ref.len] = '\0';
         str_str_set_len(str, str_len+ref.len);
     }
-    return ok;
+    return ptr != NULL;
 }
 
 #ifdef __cplusplus
 }
+
+/** \brief Append all pieces at once.
+ *
+ * str_str_catv(&url, scheme, str_ref("://", 3), host, path);
+ */
+template<typename... Refs>
+inline bool str_str_catv(StrStr * str, StrRef ref, Refs... refs)
+{
+    StrRef const arr[] = { ref, refs... };
+    return str_str_catv(str, arr, 1 + sizeof...(refs));
+}
 #endif
 
 #endif//LIBSTR_STR_H_INCLUDED
@@ -0,0 +1,175 @@
+#include <str/alloc.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// -- Default allocator --
+
+static void * str_malloc(void * ctx, size_t size)
+{
+    (void)ctx;
+    return malloc(size);
+}
+
+static void * str_realloc(void * ctx, void * ptr, size_t old_size, size_t size)
+{
+    (void)ctx; (void)old_size;
+    return realloc(ptr, size);
+}
+
+static void str_free(void * ctx, void * ptr, size_t size)
+{
+    (void)ctx; (void)size;
+    free(ptr);
+}
+
+static StrAlloc const STR_ALLOC_MALLOC =
+{
+    .alloc = str_malloc,
+    .realloc = str_realloc,
+    .free = str_free,
+    .ctx = NULL
+};
+
+static StrAlloc const * str_alloc_global = NULL;
+static _Thread_local StrAlloc const * str_alloc_thread = NULL;
+
+// -- Selection --
+
+/** \brief Allocator using malloc/realloc/free.
+ *
+ * Blocks from this allocator carry no header.
+ */
+StrAlloc const * str_alloc_default(void)
+{
+    return &STR_ALLOC_MALLOC;
+}
+
+/** \brief Allocator used for new allocations.
+ *
+ * Thread allocator if set, otherwise global allocator if set,
+ * otherwise default allocator.
+ */
+StrAlloc const * str_alloc_get(void)
+{
+    if(str_alloc_thread)
+        return str_alloc_thread;
+    if(str_alloc_global)
+        return str_alloc_global;
+    return &STR_ALLOC_MALLOC;
+}
+
+/** \brief Set process-wide allocator.
+ *
+ * NULL resets to default. Not thread safe, set it before strings are used.
+ * Strings allocated before keep their allocator.
+ *
+ * \return previous global allocator
+ */
+StrAlloc const * str_alloc_set_global(StrAlloc const * alloc)
+{
+    StrAlloc const * old = str_alloc_global;
+    str_alloc_global = alloc;
+    return old;
+}
+
+/** \brief Set allocator of the calling thread.
+ *
+ * Overrides global allocator, NULL resets to global.
+ * Strings allocated before keep their allocator.
+ *
+ * StrAlloc const * old = str_alloc_set_thread(&my_alloc);
+ * ... // all new string allocations use my_alloc
+ * str_alloc_set_thread(old);
+ *
+ * \return previous thread allocator
+ */
+StrAlloc const * str_alloc_set_thread(StrAlloc const * alloc)
+{
+    StrAlloc const * old = str_alloc_thread;
+    str_alloc_thread = alloc;
+    return old;
+}
+
+// -- Heap blocks --
+
+// header in front of data of blocks from non-default allocator
+typedef struct StrHeapHdr_s
+{
+    StrAlloc const * alloc;
+} StrHeapHdr;
+
+static inline StrHeapHdr * str_heap_hdr(char * ptr)
+{
+    assert((uintptr_t)ptr & STR_HEAP_CARRY);
+    return (StrHeapHdr*)(ptr - STR_HEAP_CARRY - sizeof(StrHeapHdr));
+}
+
+/** \brief Allocate size bytes for string data.
+ *
+ * Blocks from non-default allocators are prefixed by header with
+ * the allocator, so they can be released by str_heap_free regardless
+ * of the allocator selected at that time.
+ * Blocks from allocators without free are not tagged and can't be freed.
+ *
+ * \return tagged pointer to data or NULL
+ */
+char * str_heap_alloc(StrAlloc const * alloc, size_t size)
+{
+    if(alloc == &STR_ALLOC_MALLOC)
+        return malloc(size);
+    if(!alloc->free) // memory owned by allocator, never freed
+        return alloc->alloc(alloc->ctx, size);
+    if(size > SIZE_MAX - sizeof(StrHeapHdr))
+        return NULL;
+    StrHeapHdr * hdr = alloc->alloc(alloc->ctx, sizeof(StrHeapHdr) + size);
+    if(!hdr)
+        return NULL;
+    assert(((uintptr_t)hdr & 0x3) == 0);
+    hdr->alloc = alloc;
+    return (char*)(hdr + 1) + STR_HEAP_CARRY;
+}
+
+/** \brief Resize block from str_heap_alloc using its own allocator.
+ *
+ * \return tagged pointer to data or NULL, ptr is still valid in such case
+ */
+char * str_heap_realloc(char * ptr, size_t old_size, size_t size)
+{
+    if(!((uintptr_t)ptr & STR_HEAP_CARRY))
+        return realloc(ptr, size);
+    if(size > SIZE_MAX - sizeof(StrHeapHdr))
+        return NULL;
+    StrHeapHdr * hdr = str_heap_hdr(ptr);
+    StrAlloc const * alloc = hdr->alloc;
+    if(alloc->realloc)
+    {
+        hdr = alloc->realloc(alloc->ctx, hdr,
+            sizeof(StrHeapHdr) + old_size, sizeof(StrHeapHdr) + size);
+        return hdr ? (char*)(hdr + 1) + STR_HEAP_CARRY : NULL;
+    }
+    // no realloc, copy
+    char * new_ptr = str_heap_alloc(alloc, size);
+    if(new_ptr)
+    {
+        memcpy(new_ptr - STR_HEAP_CARRY, ptr - STR_HEAP_CARRY,
+            old_size < size ? old_size : size);
+        str_heap_free(ptr, old_size);
+    }
+    return new_ptr;
+}
+
+/** \brief Release block from str_heap_alloc using its own allocator.
+ */
+void str_heap_free(char * ptr, size_t size)
+{
+    if(!((uintptr_t)ptr & STR_HEAP_CARRY))
+    {
+        free(ptr);
+        return;
+    }
+    StrHeapHdr * hdr = str_heap_hdr(ptr);
+    hdr->alloc->free(hdr->alloc->ctx, hdr, sizeof(StrHeapHdr) + size);
+}
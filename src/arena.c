@@ -0,0 +1,156 @@
+#include <str/arena.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+StrAlloc const * str_arena_allocator(StrArena * arena);
+
+// all allocations are aligned to pointer size
+#define STR_ARENA_ALIGN (sizeof(void*))
+
+/** \brief Chunk header, data follow.
+ */
+struct StrArenaChunk_s
+{
+    struct StrArenaChunk_s * prev;
+    size_t size; // data size
+};
+
+typedef struct StrArenaChunk_s StrArenaChunk;
+
+static inline char * str_arena_chunk_beg(StrArenaChunk * chunk)
+{
+    return (char*)(chunk + 1);
+}
+
+static inline size_t str_arena_round(size_t size)
+{
+    return (size + (STR_ARENA_ALIGN-1)) & ~(STR_ARENA_ALIGN-1);
+}
+
+static void * str_arena_alloc_fn(void * ctx, size_t size)
+{
+    return str_arena_alloc(ctx, size);
+}
+
+/** \brief Extend the last allocation in place.
+ *
+ * \return NULL if ptr is not the last allocation or chunk is too small
+ */
+static void * str_arena_realloc_fn(void * ctx, void * ptr, size_t old_size, size_t size)
+{
+    StrArena * arena = ctx;
+    char * const p = ptr;
+    if(!arena->chunk || (p < str_arena_chunk_beg(arena->chunk)) || (p >= arena->end)
+        || (str_arena_round(old_size) != (size_t)(arena->top - p))
+        || (size > (size_t)(arena->end - p)))
+        return NULL;
+    arena->top = p + str_arena_round(size);
+    return ptr;
+}
+
+// -- Initialization --
+
+/** \brief Initialize empty arena.
+ *
+ * chunk - size of chunks taken from malloc, 0 = default (64kB)
+ * No memory is allocated until first use.
+ */
+void str_arena_init(StrArena * arena, size_t chunk)
+{
+    arena->alloc.alloc = str_arena_alloc_fn;
+    arena->alloc.realloc = str_arena_realloc_fn;
+    arena->alloc.free = NULL; // memory is released by arena
+    arena->alloc.ctx = arena;
+    arena->chunk = NULL;
+    arena->top = NULL;
+    arena->end = NULL;
+    arena->size = chunk > 0 ? chunk : 1<<16;
+}
+
+/** \brief Release all memory.
+ */
+void str_arena_kill(StrArena * arena)
+{
+    str_arena_rewind(arena, (StrArenaMark) { .chunk = NULL, .top = NULL });
+}
+
+// -- Allocation --
+
+/** \brief Allocate size bytes by pointer bump.
+ *
+ * Allocations larger than chunk size get their own chunk.
+ *
+ * \return pointer aligned to pointer size or NULL
+ */
+void * str_arena_alloc(StrArena * arena, size_t size)
+{
+    size = str_arena_round(size);
+    if(size > (size_t)(arena->end - arena->top))
+    {
+        // new chunk
+        size_t const data = size > arena->size ? size : arena->size;
+        if(data > SIZE_MAX - sizeof(StrArenaChunk))
+            return NULL;
+        StrArenaChunk * chunk = malloc(sizeof(StrArenaChunk) + data);
+        if(!chunk)
+            return NULL;
+        chunk->prev = arena->chunk;
+        chunk->size = data;
+        arena->chunk = chunk;
+        arena->top = str_arena_chunk_beg(chunk);
+        arena->end = arena->top + data;
+    }
+    void * ptr = arena->top;
+    arena->top += size;
+    return ptr;
+}
+
+// -- Release --
+
+/** \brief Remember current state.
+ */
+StrArenaMark str_arena_mark(StrArena const * arena)
+{
+    return (StrArenaMark) { .chunk = arena->chunk, .top = arena->top };
+}
+
+/** \brief Release everything allocated since the mark.
+ *
+ * Chunks allocated after the mark are returned to malloc.
+ */
+void str_arena_rewind(StrArena * arena, StrArenaMark mark)
+{
+    while(arena->chunk != mark.chunk)
+    {
+        assert(arena->chunk);
+        StrArenaChunk * prev = arena->chunk->prev;
+        free(arena->chunk);
+        arena->chunk = prev;
+    }
+    arena->top = mark.top;
+    arena->end = mark.chunk ? str_arena_chunk_beg(mark.chunk) + mark.chunk->size : NULL;
+}
+
+/** \brief Release everything, keep the oldest chunk for reuse.
+ */
+void str_arena_reset(StrArena * arena)
+{
+    StrArenaChunk * first = arena->chunk;
+    while(first && first->prev)
+        first = first->prev;
+    str_arena_rewind(arena, (StrArenaMark) { .chunk = first,
+        .top = first ? str_arena_chunk_beg(first) : NULL });
+}
+
+/** \brief Bytes allocated from malloc, including chunk headers.
+ */
+size_t str_arena_size(StrArena const * arena)
+{
+    size_t size = 0;
+    for(StrArenaChunk const * c = arena->chunk; c; c = c->prev)
+        size += sizeof(StrArenaChunk) + c->size;
+    return size;
+}
@@ -0,0 +1,447 @@
+#include <str/ascii.h>
+
+#include "cpu.h"
+#include "swar.h"
+
+#include <assert.h>
+#include <string.h>
+
+bool str_ascii_is(char c, unsigned cls);
+bool str_ascii_is_space(char c);
+bool str_ascii_is_digit(char c);
+bool str_ascii_is_alpha(char c);
+bool str_ascii_is_alnum(char c);
+bool str_ascii_is_xdigit(char c);
+
+char str_ascii_tolower(char c);
+char str_ascii_toupper(char c);
+
+uint8_t const str_ascii_class[256] =
+{
+    [0x00 ... 0x08] = STR_ASCII_CNTRL,
+    ['\t' ... '\r'] = STR_ASCII_CNTRL | STR_ASCII_SPACE,
+    [0x0e ... 0x1f] = STR_ASCII_CNTRL,
+    [' '] = STR_ASCII_SPACE,
+    ['!' ... '/'] = STR_ASCII_PUNCT,
+    ['0' ... '9'] = STR_ASCII_DIGIT | STR_ASCII_XDIGIT,
+    [':' ... '@'] = STR_ASCII_PUNCT,
+    ['A' ... 'F'] = STR_ASCII_UPPER | STR_ASCII_XDIGIT,
+    ['G' ... 'Z'] = STR_ASCII_UPPER,
+    ['[' ... '`'] = STR_ASCII_PUNCT,
+    ['a' ... 'f'] = STR_ASCII_LOWER | STR_ASCII_XDIGIT,
+    ['g' ... 'z'] = STR_ASCII_LOWER,
+    ['{' ... '~'] = STR_ASCII_PUNCT,
+    [0x7f] = STR_ASCII_CNTRL,
+};
+
+// Space spans
+//
+// Scanners return position of the first non-space byte from the front,
+// or past the last non-space byte from the back.
+
+typedef size_t StrSpanFn(char const * ptr, size_t len);
+
+// -- Scalar --
+
+static size_t str_span_space_scalar(char const * ptr, size_t len)
+{
+    size_t i = 0;
+    while((i < len) && str_ascii_is_space(ptr[i]))
+        ++i;
+    return i;
+}
+
+static size_t str_rspan_space_scalar(char const * ptr, size_t len)
+{
+    while((len > 0) && str_ascii_is_space(ptr[len-1]))
+        --len;
+    return len;
+}
+
+#ifdef STR_SIMD_X86
+
+// space is ' ' or '\t' ... '\r', one compare and one range check
+
+// -- SSE2 --
+
+__attribute__((target("sse2")))
+static inline unsigned str_space_mask_sse2(char const * p)
+{
+    __m128i const x = _mm_loadu_si128((__m128i const *)p);
+    __m128i const t = _mm_sub_epi8(x, _mm_set1_epi8('\t'));
+    __m128i const sp = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+        _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8('\r' - '\t')), t));
+    return _mm_movemask_epi8(sp);
+}
+
+__attribute__((target("sse2")))
+static size_t str_span_space_sse2(char const * ptr, size_t len)
+{
+    size_t i = 0;
+    for(; i + 16 <= len; i += 16)
+    {
+        unsigned const mask = ~str_space_mask_sse2(ptr + i) & 0xffff;
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return i + str_span_space_scalar(ptr + i, len - i);
+}
+
+__attribute__((target("sse2")))
+static size_t str_rspan_space_sse2(char const * ptr, size_t len)
+{
+    for(; len >= 16; len -= 16)
+    {
+        unsigned const mask = ~str_space_mask_sse2(ptr + len - 16) & 0xffff;
+        if(mask)
+            return len - 16 + 32 - __builtin_clz(mask);
+    }
+    return str_rspan_space_scalar(ptr, len);
+}
+
+// -- AVX2 --
+
+__attribute__((target("avx2")))
+static inline unsigned str_space_mask_avx2(char const * p)
+{
+    __m256i const x = _mm256_loadu_si256((__m256i const *)p);
+    __m256i const t = _mm256_sub_epi8(x, _mm256_set1_epi8('\t'));
+    __m256i const sp = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+        _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8('\r' - '\t')), t));
+    return _mm256_movemask_epi8(sp);
+}
+
+__attribute__((target("avx2")))
+static size_t str_span_space_avx2(char const * ptr, size_t len)
+{
+    size_t i = 0;
+    for(; i + 32 <= len; i += 32)
+    {
+        unsigned const mask = ~str_space_mask_avx2(ptr + i);
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    _mm256_zeroupper();
+    return i + str_span_space_sse2(ptr + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static size_t str_rspan_space_avx2(char const * ptr, size_t len)
+{
+    for(; len >= 32; len -= 32)
+    {
+        unsigned const mask = ~str_space_mask_avx2(ptr + len - 32);
+        if(mask)
+            return len - 32 + 32 - __builtin_clz(mask);
+    }
+    _mm256_zeroupper();
+    return str_rspan_space_sse2(ptr, len);
+}
+
+#endif
+
+// -- Dispatch --
+
+static StrSpanFn str_span_space_resolve;
+static StrSpanFn * str_span_space_impl = str_span_space_resolve;
+
+static size_t str_span_space_resolve(char const * ptr, size_t len)
+{
+#ifdef STR_SIMD_X86
+    STR_CPU_RESOLVE(str_span_space_impl, str_cpu_avx2() ? str_span_space_avx2
+        : str_cpu_sse2() ? str_span_space_sse2 : str_span_space_scalar);
+#else
+    STR_CPU_RESOLVE(str_span_space_impl, str_span_space_scalar);
+#endif
+    return STR_CPU_IMPL(str_span_space_impl)(ptr, len);
+}
+
+static StrSpanFn str_rspan_space_resolve;
+static StrSpanFn * str_rspan_space_impl = str_rspan_space_resolve;
+
+static size_t str_rspan_space_resolve(char const * ptr, size_t len)
+{
+#ifdef STR_SIMD_X86
+    STR_CPU_RESOLVE(str_rspan_space_impl, str_cpu_avx2() ? str_rspan_space_avx2
+        : str_cpu_sse2() ? str_rspan_space_sse2 : str_rspan_space_scalar);
+#else
+    STR_CPU_RESOLVE(str_rspan_space_impl, str_rspan_space_scalar);
+#endif
+    return STR_CPU_IMPL(str_rspan_space_impl)(ptr, len);
+}
+
+// Case conversion
+//
+// Letters are a range of 26 bytes starting at first ('A' or 'a'),
+// conversion flips bit 0x20 of letters.
+
+typedef void StrCaseFn(char * dst, char const * src, size_t len, char first);
+
+// -- Scalar --
+
+static void str_case_scalar(char * dst, char const * src, size_t len, char first)
+{
+    for(size_t i = 0; i < len; ++i)
+    {
+        char const c = src[i];
+        dst[i] = (unsigned char)(c - first) < 26 ? (char)(c ^ 0x20) : c;
+    }
+}
+
+#ifdef STR_SIMD_X86
+
+// -- SSE2 --
+
+__attribute__((target("sse2")))
+static void str_case_sse2(char * dst, char const * src, size_t len, char first)
+{
+    __m128i const beg = _mm_set1_epi8(first);
+    __m128i const max = _mm_set1_epi8(25);
+    __m128i const bit = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for(; i + 16 <= len; i += 16)
+    {
+        __m128i const x = _mm_loadu_si128((__m128i const *)(src + i));
+        __m128i const t = _mm_sub_epi8(x, beg);
+        __m128i const letter = _mm_cmpeq_epi8(_mm_min_epu8(t, max), t);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_xor_si128(x, _mm_and_si128(letter, bit)));
+    }
+    str_case_scalar(dst + i, src + i, len - i, first);
+}
+
+// -- AVX2 --
+
+__attribute__((target("avx2")))
+static void str_case_avx2(char * dst, char const * src, size_t len, char first)
+{
+    __m256i const beg = _mm256_set1_epi8(first);
+    __m256i const max = _mm256_set1_epi8(25);
+    __m256i const bit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for(; i + 32 <= len; i += 32)
+    {
+        __m256i const x = _mm256_loadu_si256((__m256i const *)(src + i));
+        __m256i const t = _mm256_sub_epi8(x, beg);
+        __m256i const letter = _mm256_cmpeq_epi8(_mm256_min_epu8(t, max), t);
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_xor_si256(x, _mm256_and_si256(letter, bit)));
+    }
+    _mm256_zeroupper();
+    str_case_sse2(dst + i, src + i, len - i, first);
+}
+
+// -- AVX-512 --
+
+__attribute__((target("avx512bw")))
+static void str_case_avx512(char * dst, char const * src, size_t len, char first)
+{
+    __m512i const beg = _mm512_set1_epi8(first);
+    __m512i const end = _mm512_set1_epi8(26);
+    __m512i const bit = _mm512_set1_epi8(0x20);
+    for(size_t i = 0; i < len; i += 64)
+    {
+        // masked loads and stores cover the tail, masked out bytes don't fault
+        __mmask64 const in = len - i >= 64 ? ~(__mmask64)0 : ((__mmask64)1 << (len - i)) - 1;
+        __m512i const x = _mm512_maskz_loadu_epi8(in, src + i);
+        __mmask64 const letter = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(x, beg), end);
+        _mm512_mask_storeu_epi8(dst + i, in, _mm512_mask_blend_epi8(letter, x, _mm512_xor_si512(x, bit)));
+    }
+}
+
+#endif
+
+// -- Dispatch --
+
+static StrCaseFn str_case_resolve;
+static StrCaseFn * str_case_impl = str_case_resolve;
+
+static void str_case_resolve(char * dst, char const * src, size_t len, char first)
+{
+#ifdef STR_SIMD_X86
+    STR_CPU_RESOLVE(str_case_impl, str_cpu_avx512bw() ? str_case_avx512
+        : str_cpu_avx2() ? str_case_avx2
+        : str_cpu_sse2() ? str_case_sse2 : str_case_scalar);
+#else
+    STR_CPU_RESOLVE(str_case_impl, str_case_scalar);
+#endif
+    STR_CPU_IMPL(str_case_impl)(dst, src, len, first);
+}
+
+// Case insensitive comparison
+//
+// SSE2 is part of x86-64, the baseline build uses it without dispatch:
+// blocks of 16 bytes are converted to lower case and compared,
+// 8 to 15 bytes are loaded as two overlapping halves of a block.
+// Otherwise words of 8 bytes are compared, converted only if they differ.
+
+#if defined(STR_SIMD_X86) && defined(__SSE2__)
+
+static inline __m128i str_cmp_lower_sse2(__m128i x)
+{
+    // signed compare, bytes >= 0x80 are below 'A'
+    __m128i const upper = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('A' - 1)),
+        _mm_cmplt_epi8(x, _mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(x, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+/** \brief Load 8 to 16 bytes, the rest of the block repeats some of them.
+ */
+static inline __m128i str_cmp_load_sse2(char const * p, size_t n)
+{
+    assert((n >= 8) && (n <= 16));
+    return n == 16 ? _mm_loadu_si128((__m128i const *)p)
+        : _mm_unpacklo_epi64(_mm_loadl_epi64((__m128i const *)p),
+            _mm_loadl_epi64((__m128i const *)(p + n - 8)));
+}
+
+/** \brief Mask of bytes different ignoring case, n in 8 ... 16.
+ */
+static inline unsigned str_cmp_ci_mask_sse2(char const * a, char const * b, size_t n)
+{
+    __m128i const x = str_cmp_lower_sse2(str_cmp_load_sse2(a, n));
+    __m128i const y = str_cmp_lower_sse2(str_cmp_load_sse2(b, n));
+    return ~_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) & 0xffff;
+}
+
+#else
+
+static inline uint64_t str_cmp_r8(char const * p)
+{
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+#endif
+
+/** \brief Pack n < 8 bytes into a word, same positions for same n.
+ */
+static inline uint64_t str_cmp_rn(char const * p, size_t n)
+{
+    assert(n < 8);
+    if(n >= 4)
+    {
+        uint32_t lo, hi;
+        memcpy(&lo, p, 4);
+        memcpy(&hi, p + n - 4, 4);
+        return lo | (uint64_t)hi << 32;
+    }
+    unsigned char const * u = (unsigned char const *)p;
+    return n ? u[0] | (uint64_t)u[n>>1] << 8 | (uint64_t)u[n-1] << 16 : 0;
+}
+
+static inline int str_cmp_ci_byte(char a, char b)
+{
+    return (unsigned char)str_ascii_tolower(a) - (unsigned char)str_ascii_tolower(b);
+}
+
+// -- Queries --
+
+/** \brief Compare len bytes for equality ignoring case.
+ */
+bool str_ascii_cmp_eq_ci_n(char const * a, char const * b, size_t len)
+{
+    assert((a && b) || (len == 0));
+    if(len < 8)
+        return str_swar_lower(str_cmp_rn(a, len)) == str_swar_lower(str_cmp_rn(b, len));
+#if defined(STR_SIMD_X86) && defined(__SSE2__)
+    size_t i = 0;
+    for(; len - i > 16; i += 16)
+        if(str_cmp_ci_mask_sse2(a + i, b + i, 16))
+            return false;
+    // the last block ends at len
+    size_t const n = len - i < 8 ? 16 : len - i;
+    return !str_cmp_ci_mask_sse2(a + len - n, b + len - n, n);
+#else
+    // the last word ends at len, it may overlap the previous one
+    for(size_t i = 0; ; i += 8)
+    {
+        if(i + 8 > len)
+            i = len - 8;
+        uint64_t const x = str_cmp_r8(a + i);
+        uint64_t const y = str_cmp_r8(b + i);
+        if((x != y) && (str_swar_lower(x) != str_swar_lower(y)))
+            return false;
+        if(i + 8 == len)
+            return true;
+    }
+#endif
+}
+
+/** \brief Compare len bytes converted to lower case.
+ *
+ * \return <0, 0, >0 like memcmp
+ */
+int str_ascii_cmp_ci_n(char const * a, char const * b, size_t len)
+{
+    assert((a && b) || (len == 0));
+    size_t i = 0;
+#if defined(STR_SIMD_X86) && defined(__SSE2__)
+    for(; len - i >= 8; i += 16)
+    {
+        size_t const n = len - i < 16 ? len - i : 16;
+        unsigned const mask = str_cmp_ci_mask_sse2(a + i, b + i, n);
+        if(mask)
+        {
+            // positions of the second half count from the end
+            size_t const pos = __builtin_ctz(mask);
+            size_t const k = pos < 8 ? i + pos : i + n - 16 + pos;
+            return str_cmp_ci_byte(a[k], b[k]);
+        }
+        if(n < 16)
+            return 0;
+    }
+#else
+    for(; i + 8 <= len; i += 8)
+    {
+        uint64_t const x = str_cmp_r8(a + i);
+        uint64_t const y = str_cmp_r8(b + i);
+        if((x != y) && (str_swar_lower(x) != str_swar_lower(y)))
+            break;
+    }
+#endif
+    for(; i < len; ++i)
+    {
+        int const cmp = str_cmp_ci_byte(a[i], b[i]);
+        if(cmp)
+            return cmp;
+    }
+    return 0;
+}
+
+/** \brief Number of leading spaces.
+ */
+size_t str_ascii_span_space(char const * ptr, size_t len)
+{
+    assert(ptr || (len == 0));
+    return STR_CPU_IMPL(str_span_space_impl)(ptr, len);
+}
+
+/** \brief Number of trailing spaces.
+ */
+size_t str_ascii_rspan_space(char const * ptr, size_t len)
+{
+    assert(ptr || (len == 0));
+    return len - STR_CPU_IMPL(str_rspan_space_impl)(ptr, len);
+}
+
+// -- Conversion --
+
+/** \brief Copy len bytes converting ASCII letters to lower case.
+ *
+ * dst may be equal to src for conversion in place, other bytes are copied.
+ */
+void str_ascii_tolower_n(char * dst, char const * src, size_t len)
+{
+    assert((dst && src) || (len == 0));
+    STR_CPU_IMPL(str_case_impl)(dst, src, len, 'A');
+}
+
+/** \brief Copy len bytes converting ASCII letters to upper case.
+ *
+ * dst may be equal to src for conversion in place, other bytes are copied.
+ */
+void str_ascii_toupper_n(char * dst, char const * src, size_t len)
+{
+    assert((dst && src) || (len == 0));
+    STR_CPU_IMPL(str_case_impl)(dst, src, len, 'a');
+}
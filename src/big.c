@@ -0,0 +1,164 @@
+#include <str/big.h>
+
+#include "grow.h"
+
+StrTag str_big_get_tag(StrBig const * big);
+size_t str_big_get_len(StrBig const * big);
+size_t str_big_get_cap(StrBig const * big);
+char const * str_big_get_ptr(StrBig const * big);
+void str_big_set_len(StrBig * big, size_t len);
+void str_big_set_tag_len_cap(StrBig * big, StrTag tag, size_t len, size_t cap);
+
+bool str_big_is_null(StrBig const * big);
+bool str_big_is_empty(StrBig const * big);
+bool str_big_is_mutable(StrBig const * big);
+
+size_t str_big_len(StrBig const * big);
+size_t str_big_cap(StrBig const * big);
+char const * str_big_ptr(StrBig const * big);
+char * str_big_ptr_mut(StrBig * big);
+StrRef str_big_ref(StrBig const * big);
+
+// -- Initialization --
+
+void str_big_init_null(StrBig * big);
+void str_big_init_empty(StrBig * big);
+void str_big_init_move(StrBig * restrict dst, StrBig * restrict src);
+void str_big_init_const(StrBig * big, StrRef ref);
+
+/** \brief Initialize string by copy of ref.
+ *
+ * Short contents are stored inside, long ones get exactly len+1 bytes
+ * from the current allocator. Null ref gives null string.
+ *
+ * \return false if allocation failed, big is null then.
+ */
+bool str_big_init_copy(StrBig * big, StrRef ref)
+{
+    STR_REF_ASSERT(&ref);
+    if(!ref.ptr)
+    {
+        str_big_init_null(big);
+        return true;
+    }
+    str_big_init_empty(big);
+    if(!str_big_alloc(big, ref.len, 0))
+    {
+        str_big_init_null(big);
+        return false;
+    }
+    char * ptr = str_big_ptr_mut(big);
+    memcpy(ptr, ref.ptr, ref.len);
+    ptr[ref.len] = '\0';
+    str_big_set_len(big, ref.len);
+    return true;
+}
+
+// -- Deinitialization --
+
+void str_big_kill(StrBig * big);
+
+// -- Assignment --
+
+void str_big_set_null(StrBig * big);
+void str_big_set_empty(StrBig * big);
+void str_big_set_move(StrBig * restrict dst, StrBig * restrict src);
+void str_big_set_const(StrBig * big, StrRef ref);
+
+// -- Allocation --
+
+/** \brief Allocate storage for cap characters, keep len characters.
+ *
+ * len == 0 drops the contents, len == SIZE_MAX keeps all of them.
+ * Uses allocator of the calling thread for new blocks (see str_alloc_get),
+ * strings from allocators without free are weak like in str_str_alloc_with.
+ *
+ * \return false if cap is too big or allocation failed, big is unchanged then.
+ */
+bool str_big_alloc(StrBig * big, size_t cap, size_t len)
+{
+    STR_BIG_ASSERT(big);
+    if(cap > STR_BIG_CAP_MAX)
+        return false;
+    if(len > cap) // only new cap bytes can be preserved
+        len = cap;
+    if(len > str_big_get_len(big)) // only old len bytes can be preserved
+        len = str_big_get_len(big);
+    if((cap <= str_big_get_cap(big)) && str_big_is_mutable(big))
+    {
+        str_big_ptr_mut(big)[len] = '\0';
+        str_big_set_len(big, len);
+        return true;
+    }
+    if(cap <= STR_BIG_SSO_CAP)
+    {
+        StrBig old;
+        memcpy(&old, big, sizeof(StrBig));
+        str_big_init_empty(big);
+        memcpy(big->sso.dat, str_big_ptr(&old), len);
+        str_big_set_len(big, len);
+        str_big_kill(&old);
+        return true;
+    }
+    StrAlloc const * alloc = str_alloc_get();
+    StrTag tag = alloc->free ? STR_TAG_STR : STR_TAG_REF;
+    char * ptr = NULL;
+    if((str_big_get_tag(big) == STR_TAG_STR) && (len > 0))
+    {
+        // own buffer with contents to keep
+        ptr = str_heap_realloc(big->rep.ptr, str_big_get_cap(big)+1, cap+1);
+        if(!ptr)
+            return false;
+        tag = STR_TAG_STR;
+    }
+    else
+    {
+        ptr = str_heap_alloc(alloc, cap+1);
+        if(!ptr)
+            return false;
+        memcpy((char*)((uintptr_t)ptr & ~STR_PTR_FLAGS), str_big_get_ptr(big), len);
+        str_big_kill(big);
+    }
+    ((char*)((uintptr_t)ptr & ~STR_PTR_FLAGS))[len] = '\0';
+    big->rep.ptr = ptr;
+    str_big_set_tag_len_cap(big, tag, len, cap);
+    return true;
+}
+
+/** \brief Ensure capacity for at least cap characters, keep contents.
+ *
+ * Capacity of mutable strings grows geometrically by the same factor
+ * as StrStr (see str_str_set_growth), so repeated appends are amortized
+ * O(1). Immutable strings are copied with exact capacity.
+ *
+ * \return false if allocation failed, string is unchanged in such case.
+ */
+bool str_big_grow(StrBig * big, size_t cap)
+{
+    STR_BIG_ASSERT(big);
+    size_t const old_cap = str_big_get_cap(big);
+    if((cap <= old_cap) && (old_cap > 0))
+        return true;
+    if(old_cap > 0)
+        cap = str_grow_cap(old_cap, cap, STR_BIG_CAP_MAX);
+    return str_big_alloc(big, cap, SIZE_MAX);
+}
+
+// -- Modification --
+
+/** \brief Get pointer to zero-terminated string contents.
+ *
+ * Const strings are copied, their terminator may not be readable.
+ *
+ * \return NULL if string contains '\0' or allocation fails.
+ */
+char const * str_big_cstr(StrBig * big)
+{
+    size_t const len = str_big_len(big);// PRE big ok
+    if(!str_big_is_mutable(big) && !str_big_alloc(big, len, SIZE_MAX))
+        return NULL;
+    char const * ptr = str_big_get_ptr(big);
+    return memchr(ptr, '\0', len) ? NULL : ptr;
+}
+
+bool str_big_cat(StrBig * big, StrRef ref);
@@ -0,0 +1,238 @@
+#include <str/charset.h>
+
+#include "cpu.h"
+#include "split.h"
+
+bool str_charset_has(StrCharSet const * set, char c);
+
+void str_split_init(StrSplit * split, StrRef ref, StrCharSet const * set);
+bool str_split_next(StrSplit * split, StrRef * field);
+
+typedef size_t StrFindAnyFn(char const * ptr, size_t len, StrCharSet const * set);
+typedef void StrSplitAnyFn(char const * ptr, size_t len, size_t i, StrCharSet const * set, StrSplitOut * o);
+
+// -- Scalar --
+
+static size_t str_find_any_scalar(char const * ptr, size_t len, StrCharSet const * set)
+{
+    for(size_t i = 0; i < len; ++i)
+        if(str_charset_has(set, ptr[i]))
+            return i;
+    return SIZE_MAX;
+}
+
+static void str_split_any_scalar(char const * ptr, size_t len, size_t i, StrCharSet const * set, StrSplitOut * o)
+{
+    for(; (i < len) && (o->k < o->cnt); ++i)
+        if(str_charset_has(set, ptr[i]))
+            str_split_emit(o, ptr, i);
+}
+
+#ifdef STR_SIMD_X86
+
+// Member test of 16/32 bytes at once : the low nibble selects a byte of
+// set->lo with a bit for each possible high nibble, the high nibble
+// selects that bit from set->hi (W. Mula, SIMD byte lookup).
+
+// -- SSSE3 --
+
+// bit set for members among 16 bytes at p
+__attribute__((target("ssse3")))
+static inline unsigned str_charset_mask_ssse3(__m128i lo, __m128i hi, char const * p)
+{
+    __m128i const nib = _mm_set1_epi8(0x0f);
+    __m128i const x = _mm_loadu_si128((__m128i const *)p);
+    __m128i const l = _mm_shuffle_epi8(lo, _mm_and_si128(x, nib));
+    __m128i const h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(x, 4), nib));
+    __m128i const no = _mm_cmpeq_epi8(_mm_and_si128(l, h), _mm_setzero_si128());
+    return ~_mm_movemask_epi8(no) & 0xffff;
+}
+
+__attribute__((target("ssse3")))
+static size_t str_find_any_ssse3(char const * ptr, size_t len, StrCharSet const * set)
+{
+    __m128i const lo = _mm_loadu_si128((__m128i const *)set->lo);
+    __m128i const hi = _mm_loadu_si128((__m128i const *)set->hi);
+    size_t i = 0;
+    for(; i + 16 <= len; i += 16)
+    {
+        unsigned const mask = str_charset_mask_ssse3(lo, hi, ptr + i);
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    size_t const pos = str_find_any_scalar(ptr + i, len - i, set);
+    return pos == SIZE_MAX ? pos : i + pos;
+}
+
+__attribute__((target("ssse3")))
+static void str_split_any_ssse3(char const * ptr, size_t len, size_t i, StrCharSet const * set, StrSplitOut * o)
+{
+    __m128i const lo = _mm_loadu_si128((__m128i const *)set->lo);
+    __m128i const hi = _mm_loadu_si128((__m128i const *)set->hi);
+    for(; (i + 16 <= len) && (o->k < o->cnt); i += 16)
+        str_split_emit_mask(o, ptr, i, str_charset_mask_ssse3(lo, hi, ptr + i));
+    str_split_any_scalar(ptr, len, i, set, o);
+}
+
+// -- AVX2 --
+
+// bit set for members among 32 bytes at p
+__attribute__((target("avx2")))
+static inline unsigned str_charset_mask_avx2(__m256i lo, __m256i hi, char const * p)
+{
+    __m256i const nib = _mm256_set1_epi8(0x0f);
+    __m256i const x = _mm256_loadu_si256((__m256i const *)p);
+    __m256i const l = _mm256_shuffle_epi8(lo, _mm256_and_si256(x, nib));
+    __m256i const h = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(x, 4), nib));
+    __m256i const no = _mm256_cmpeq_epi8(_mm256_and_si256(l, h), _mm256_setzero_si256());
+    return ~(unsigned)_mm256_movemask_epi8(no);
+}
+
+__attribute__((target("avx2")))
+static size_t str_find_any_avx2(char const * ptr, size_t len, StrCharSet const * set)
+{
+    // vpshufb looks up within 128-bit lanes, both get the same tables
+    __m256i const lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)set->lo));
+    __m256i const hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)set->hi));
+    size_t i = 0;
+    for(; i + 32 <= len; i += 32)
+    {
+        unsigned const mask = str_charset_mask_avx2(lo, hi, ptr + i);
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    if(i == len)
+        return SIZE_MAX;
+    _mm256_zeroupper();
+    size_t const pos = str_find_any_ssse3(ptr + i, len - i, set);
+    return pos == SIZE_MAX ? pos : i + pos;
+}
+
+__attribute__((target("avx2")))
+static void str_split_any_avx2(char const * ptr, size_t len, size_t i, StrCharSet const * set, StrSplitOut * o)
+{
+    __m256i const lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)set->lo));
+    __m256i const hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)set->hi));
+    for(; (i + 64 <= len) && (o->k < o->cnt); i += 64)
+    {
+        uint64_t const mask = str_charset_mask_avx2(lo, hi, ptr + i)
+            | (uint64_t)str_charset_mask_avx2(lo, hi, ptr + i + 32) << 32;
+        str_split_emit_mask(o, ptr, i, mask);
+    }
+    _mm256_zeroupper();
+    str_split_any_ssse3(ptr, len, i, set, o);
+}
+
+#endif
+
+// -- Dispatch --
+
+static StrFindAnyFn str_find_any_resolve;
+static StrFindAnyFn * str_find_any_impl = str_find_any_resolve;
+
+static size_t str_find_any_resolve(char const * ptr, size_t len, StrCharSet const * set)
+{
+#ifdef STR_SIMD_X86
+    STR_CPU_RESOLVE(str_find_any_impl, str_cpu_avx2() ? str_find_any_avx2
+        : str_cpu_ssse3() ? str_find_any_ssse3 : str_find_any_scalar);
+#else
+    STR_CPU_RESOLVE(str_find_any_impl, str_find_any_scalar);
+#endif
+    return STR_CPU_IMPL(str_find_any_impl)(ptr, len, set);
+}
+
+static StrSplitAnyFn str_split_any_resolve;
+static StrSplitAnyFn * str_split_any_impl = str_split_any_resolve;
+
+static void str_split_any_resolve(char const * ptr, size_t len, size_t i, StrCharSet const * set, StrSplitOut * o)
+{
+#ifdef STR_SIMD_X86
+    STR_CPU_RESOLVE(str_split_any_impl, str_cpu_avx2() ? str_split_any_avx2
+        : str_cpu_ssse3() ? str_split_any_ssse3 : str_split_any_scalar);
+#else
+    STR_CPU_RESOLVE(str_split_any_impl, str_split_any_scalar);
+#endif
+    STR_CPU_IMPL(str_split_any_impl)(ptr, len, i, set, o);
+}
+
+// -- Construction --
+
+/** \brief Initialize set of all bytes in chars.
+ */
+void str_charset_init(StrCharSet * set, StrRef chars)
+{
+    STR_REF_ASSERT(&chars);
+    memset(set, 0, sizeof(StrCharSet));
+    set->ascii = true;
+    for(size_t i = 0; i < chars.len; ++i)
+    {
+        unsigned char const c = chars.ptr[i];
+        set->bit[c>>6] |= (uint64_t)1 << (c & 63);
+        if(c < 0x80)
+        {
+            set->lo[c & 0xf] |= 1 << (c >> 4);
+            set->hi[c >> 4] = 1 << (c >> 4);
+        }
+        else
+            set->ascii = false;
+    }
+}
+
+// -- Decomposition --
+
+/** \brief Find position of the first byte from set.
+ *
+ * \return SIZE_MAX if not found.
+ */
+size_t str_ref_find_any(StrRef ref, StrCharSet const * set)
+{
+    STR_REF_ASSERT(&ref);
+    // vectorized lookup knows only ASCII members
+    return set->ascii
+        ? STR_CPU_IMPL(str_find_any_impl)(ref.ptr, ref.len, set)
+        : str_find_any_scalar(ref.ptr, ref.len, set);
+}
+
+/** \brief Cut and return first word.
+ *
+ * Like str_ref_word_c, separator is any byte from set.
+ */
+StrRef str_ref_word_any(StrRef * ref, StrCharSet const * set)
+{
+    STR_REF_ASSERT(ref);
+    size_t const pos = str_ref_find_any(*ref, set);
+    StrRef ret;
+    ret.ptr = ref->ptr;
+    if(pos != SIZE_MAX)
+    {
+        ret.len = pos;
+        ref->ptr += pos + 1;
+        ref->len -= pos + 1;
+    }
+    else
+    {
+        ret.len = ref->len;
+        ref->ptr += ref->len;
+        ref->len = 0;
+    }
+    return ret;
+}
+
+/** \brief Cut up to cnt words at once.
+ *
+ * Like str_ref_split_c, separator is any byte from set.
+ *
+ * \return number of fields stored to out
+ */
+size_t str_ref_split_any(StrRef * ref, StrCharSet const * set, StrRef * out, size_t cnt)
+{
+    STR_REF_ASSERT(ref);
+    if(!ref->ptr || !cnt)
+        return 0;
+    StrSplitOut o = { out, cnt, 0, 0 };
+    if(set->ascii)
+        STR_CPU_IMPL(str_split_any_impl)(ref->ptr, ref->len, 0, set, &o);
+    else
+        str_split_any_scalar(ref->ptr, ref->len, 0, set, &o);
+    return str_split_finish(&o, ref);
+}
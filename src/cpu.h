@@ -0,0 +1,66 @@
+#ifndef LIBSTR_CPU_H_INCLUDED
+#define LIBSTR_CPU_H_INCLUDED
+
+// Internal header, SIMD code selection.
+//
+// SIMD variants are compiled with target attributes, so the library
+// needs no special flags, and are selected at run time by CPU features.
+// Define STR_NO_SIMD to build only the portable code.
+//
+// AVX variants passing tails to SSE variants must call _mm256_zeroupper()
+// first. GCC emits vzeroupper before returns, but not always before calls
+// of local functions, and legacy SSE code running with dirty upper halves
+// of ymm registers pays a transition penalty (see "short" benchmarks).
+
+#include <stdbool.h>
+
+#if !defined(STR_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define STR_SIMD_X86 1
+# include <immintrin.h>
+#endif
+
+#ifdef STR_SIMD_X86
+
+static inline bool str_cpu_sse2(void)
+{
+    __builtin_cpu_init(); // may run before constructors of libgcc
+    return __builtin_cpu_supports("sse2");
+}
+
+static inline bool str_cpu_ssse3(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+}
+
+static inline bool str_cpu_avx2(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static inline bool str_cpu_avx512bw(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512bw");
+}
+
+#endif
+
+/** \brief Function pointer resolved on first call.
+ *
+ * static size_t foo_resolve(args);
+ * static size_t (*foo_impl)(args) = foo_resolve;
+ * static size_t foo_resolve(args)
+ * {
+ *     STR_CPU_RESOLVE(foo_impl, str_cpu_avx2() ? foo_avx2 : foo_scalar);
+ *     return foo_impl(args);
+ * }
+ *
+ * Concurrent first calls store the same value.
+ */
+#define STR_CPU_RESOLVE(impl, fun) __atomic_store_n(&(impl), (fun), __ATOMIC_RELAXED)
+
+#define STR_CPU_IMPL(impl) __atomic_load_n(&(impl), __ATOMIC_RELAXED)
+
+#endif//LIBSTR_CPU_H_INCLUDED
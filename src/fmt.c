@@ -155,8 +155,7 @@ size_t str_cpy_tolower(char ** dst, size_t * cap, StrRef ref)
 {
     if(dst && cap && (*cap > ref.len))
     {
-        for(size_t i = 0; i < ref.len; ++i)
-            (*dst)[i] = tolower(ref.ptr[i]);
+        str_ascii_tolower_n(*dst, ref.ptr, ref.len);
         (*dst)[ref.len] = '\0';
         *dst += ref.len;
         *cap -= ref.len;
@@ -174,8 +173,7 @@ size_t str_cpy_toupper(char ** dst, size_t * cap, StrRef ref)
 {
     if(dst && cap && (*cap > ref.len))
     {
-        for(size_t i = 0; i < ref.len; ++i)
-            (*dst)[i] = toupper(ref.ptr[i]);
+        str_ascii_toupper_n(*dst, ref.ptr, ref.len);
         (*dst)[ref.len] = '\0';
         *dst += ref.len;
         *cap -= ref.len;
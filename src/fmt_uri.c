@@ -3,13 +3,12 @@
 //#include <b64/cencode.h>
 
 #include <assert.h>
-#include <ctype.h>
 #include <stdbool.h>
 
 // returns false for ' ' since it is detected separately
 static inline bool must_www_form_escape(char c)
 {
-    return !isalnum(c) && (c != ' ') && (c != '*') && (c != '-') && (c != '.') && (c != '_');
+    return !str_ascii_is_alnum(c) && (c != ' ') && (c != '*') && (c != '-') && (c != '.') && (c != '_');
 }
 
 size_t str_enc_www_form_component_size(StrRef ref)
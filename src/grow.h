@@ -0,0 +1,14 @@
+#ifndef LIBSTR_GROW_H_INCLUDED
+#define LIBSTR_GROW_H_INCLUDED
+
+// Internal header, capacity growth policy shared by StrStr and StrBig.
+
+#include <stddef.h>
+
+/** \brief Capacity to grow old_cap > 0 to, at least cap <= max.
+ *
+ * Applies the factor set by str_str_set_growth, capped at max.
+ */
+size_t str_grow_cap(size_t old_cap, size_t cap, size_t max);
+
+#endif//LIBSTR_GROW_H_INCLUDED
@@ -0,0 +1,259 @@
+#include <str/intern.h>
+#include <str/ref_hash.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool str_str_init_intern(StrStr * str, StrIntern * intern, StrRef ref);
+
+// node storage chunk of one shard
+#define STR_INTERN_CHUNK 16384
+// initial slots of one shard
+#define STR_INTERN_SLOTS 64
+
+/** \brief Interned string, contents follow.
+ */
+typedef struct StrInternNode_s
+{
+    uint64_t hash;
+    size_t len;
+} StrInternNode;
+
+/** \brief Open addressing table with linear probing.
+ */
+typedef struct StrInternTable_s
+{
+    struct StrInternTable_s * prev; // retired tables
+    size_t mask; // slots - 1
+    StrInternNode * slot[]; // atomic
+} StrInternTable;
+
+static inline char const * str_intern_node_dat(StrInternNode const * node)
+{
+    return (char const *)(node + 1);
+}
+
+static inline uint64_t str_intern_hash(StrRef ref)
+{
+    return str_ref_hash(ref, 0);
+}
+
+static inline StrInternShard * str_intern_shard(StrIntern * intern, uint64_t hash)
+{
+    // top bits, slots are chosen by low bits
+    return intern->shard + (hash >> 60) % STR_INTERN_SHARDS;
+}
+
+static inline size_t str_intern_table_size(size_t slots)
+{
+    return sizeof(StrInternTable) + slots*sizeof(StrInternNode *);
+}
+
+/** \brief Lock-free lookup.
+ *
+ * \return node or NULL, *idx is the slot where the search stopped
+ */
+static StrInternNode * str_intern_lookup(StrInternTable const * table, StrRef ref, uint64_t hash, size_t * idx)
+{
+    size_t i = hash & table->mask;
+    for(;; i = (i+1) & table->mask)
+    {
+        StrInternNode * node = __atomic_load_n(table->slot + i, __ATOMIC_ACQUIRE);
+        if(!node
+            || ((node->hash == hash) && (node->len == ref.len)
+                && (memcmp(str_intern_node_dat(node), ref.ptr, ref.len) == 0)))
+        {
+            *idx = i;
+            return node;
+        }
+    }
+}
+
+static inline void str_intern_pause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static void str_intern_lock(StrInternShard * shard)
+{
+    while(__atomic_test_and_set(&shard->lock, __ATOMIC_ACQUIRE))
+        while(__atomic_load_n(&shard->lock, __ATOMIC_RELAXED))
+            str_intern_pause();
+}
+
+static void str_intern_unlock(StrInternShard * shard)
+{
+    __atomic_clear(&shard->lock, __ATOMIC_RELEASE);
+}
+
+/** \brief Publish a table twice the size, keep the old one for readers.
+ */
+static StrInternTable * str_intern_grow(StrInternShard * shard, StrInternTable * old)
+{
+    size_t const slots = old ? 2*(old->mask+1) : STR_INTERN_SLOTS;
+    StrInternTable * table = calloc(1, str_intern_table_size(slots));
+    if(!table)
+        return NULL;
+    table->mask = slots-1;
+    if(old)
+    {
+        for(size_t i = 0; i <= old->mask; ++i)
+        {
+            StrInternNode * node = old->slot[i];
+            if(!node)
+                continue;
+            size_t j = node->hash & table->mask;
+            while(table->slot[j])
+                j = (j+1) & table->mask;
+            table->slot[j] = node;
+        }
+        old->prev = shard->retired;
+        shard->retired = old;
+    }
+    else
+        str_arena_init(&shard->arena, STR_INTERN_CHUNK);
+    shard->table_bytes += str_intern_table_size(slots);
+    __atomic_store_n(&shard->table, table, __ATOMIC_RELEASE);
+    return table;
+}
+
+// -- Initialization --
+
+/** \brief Initialize empty interner.
+ *
+ * No memory is allocated until first use.
+ */
+void str_intern_init(StrIntern * intern)
+{
+    memset(intern, 0, sizeof(StrIntern));
+}
+
+/** \brief Release all memory, interned pointers become invalid.
+ *
+ * No other thread may use the interner.
+ */
+void str_intern_kill(StrIntern * intern)
+{
+    for(size_t s = 0; s < STR_INTERN_SHARDS; ++s)
+    {
+        StrInternShard * shard = intern->shard + s;
+        if(!shard->table)
+            continue;
+        free(shard->table);
+        while(shard->retired)
+        {
+            StrInternTable * prev = shard->retired->prev;
+            free(shard->retired);
+            shard->retired = prev;
+        }
+        str_arena_kill(&shard->arena);
+    }
+    str_intern_init(intern);
+}
+
+/** \brief Process wide interner, never killed.
+ */
+StrIntern * str_intern_global(void)
+{
+    static StrIntern global;
+    return &global;
+}
+
+// -- Lookup --
+
+/** \brief Get canonical copy of ref, insert it if not present.
+ *
+ * Thread safe. The result is zero-terminated and immutable.
+ *
+ * \return null ref for null ref or if allocation failed.
+ */
+StrRef str_intern(StrIntern * intern, StrRef ref)
+{
+    STR_REF_ASSERT(&ref);
+    if(!ref.ptr)
+        return ref;
+    uint64_t const hash = str_intern_hash(ref);
+    StrInternShard * shard = str_intern_shard(intern, hash);
+    size_t idx;
+    StrInternTable * table = __atomic_load_n(&shard->table, __ATOMIC_ACQUIRE);
+    StrInternNode * node = table ? str_intern_lookup(table, ref, hash, &idx) : NULL;
+    if(node)
+        return str_ref(str_intern_node_dat(node), node->len);
+
+    str_intern_lock(shard);
+    // another writer may have inserted it or replaced the table meanwhile
+    table = shard->table;
+    node = table ? str_intern_lookup(table, ref, hash, &idx) : NULL;
+    if(!node)
+    {
+        // keep load factor <= 1/2, probes stay short
+        if(!table || (2*(shard->count+1) > table->mask+1))
+        {
+            table = str_intern_grow(shard, table);
+            if(table)
+                str_intern_lookup(table, ref, hash, &idx);
+        }
+        node = table && (ref.len < SIZE_MAX - sizeof(StrInternNode))
+            ? str_arena_alloc(&shard->arena, sizeof(StrInternNode) + ref.len + 1)
+            : NULL;
+        if(node)
+        {
+            node->hash = hash;
+            node->len = ref.len;
+            char * dat = (char *)(node + 1);
+            memcpy(dat, ref.ptr, ref.len);
+            dat[ref.len] = '\0';
+            ++shard->count;
+            shard->bytes += ref.len + 1;
+            // node contents are visible before the node
+            __atomic_store_n(table->slot + idx, node, __ATOMIC_RELEASE);
+        }
+    }
+    str_intern_unlock(shard);
+    return node ? str_ref(str_intern_node_dat(node), node->len) : str_ref_null();
+}
+
+/** \brief Get canonical copy of ref if it was interned already.
+ *
+ * Thread safe and lock-free.
+ *
+ * \return null ref if ref is not interned.
+ */
+StrRef str_intern_find(StrIntern * intern, StrRef ref)
+{
+    STR_REF_ASSERT(&ref);
+    if(!ref.ptr)
+        return ref;
+    uint64_t const hash = str_intern_hash(ref);
+    StrInternShard * shard = str_intern_shard(intern, hash);
+    size_t idx;
+    StrInternTable * table = __atomic_load_n(&shard->table, __ATOMIC_ACQUIRE);
+    StrInternNode * node = table ? str_intern_lookup(table, ref, hash, &idx) : NULL;
+    return node ? str_ref(str_intern_node_dat(node), node->len) : str_ref_null();
+}
+
+// -- Accounting --
+
+/** \brief Sum memory usage of all shards.
+ *
+ * Thread safe, shards are locked one by one.
+ */
+void str_intern_stats(StrIntern * intern, StrInternStats * stats)
+{
+    memset(stats, 0, sizeof(StrInternStats));
+    for(size_t s = 0; s < STR_INTERN_SHARDS; ++s)
+    {
+        StrInternShard * shard = intern->shard + s;
+        str_intern_lock(shard);
+        stats->count += shard->count;
+        stats->bytes += shard->bytes;
+        stats->memory += shard->table_bytes;
+        if(shard->table)
+            stats->memory += str_arena_size(&shard->arena);
+        str_intern_unlock(shard);
+    }
+}
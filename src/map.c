@@ -0,0 +1,271 @@
+#include <str/map.h>
+#include <str/ref_hash.h>
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+size_t str_map_len(StrMap const * map);
+
+// smallest table
+#define STR_MAP_SLOTS 16
+// stored hashes have 32 bits
+#define STR_MAP_SLOTS_MAX ((size_t)1<<31)
+
+static inline uint32_t str_map_hash(StrRef key)
+{
+    // 0 marks empty slots
+    uint32_t const hash = (uint32_t)str_ref_hash(key, 0);
+    return hash ? hash : 1;
+}
+
+static inline bool str_map_key_eq(StrMapSlot const * slot, StrRef key)
+{
+    // null key has NULL ptr, don't pass it to memcmp
+    return ((size_t)str_str_get_len(&slot->key) == key.len)
+        && ((key.len == 0) || (memcmp(str_str_get_ptr(&slot->key), key.ptr, key.len) == 0));
+}
+
+/** \brief Slot holding key or empty slot where it would be inserted.
+ */
+static size_t str_map_probe(StrMap const * map, StrRef key, uint32_t hash)
+{
+    size_t i = hash & map->mask;
+    while(map->hash[i] && ((map->hash[i] != hash) || !str_map_key_eq(map->slot + i, key)))
+        i = (i+1) & map->mask;
+    return i;
+}
+
+/** \brief Copy key into slot.
+ *
+ * Long keys are allocated by the default allocator, not the thread one,
+ * so they live as long as the map even if it outlives an arena.
+ */
+static bool str_map_key_init(StrStr * str, StrRef key)
+{
+    str_str_init_empty(str);
+    return (key.len <= INT_MAX)
+        && str_str_alloc_with(str, str_alloc_default(), key.len, 0)
+        && str_str_cat(str, key);
+}
+
+/** \brief Move all entries into a table with given number of slots.
+ */
+static bool str_map_rehash(StrMap * map, size_t slots)
+{
+    assert((slots & (slots-1)) == 0);
+    StrMapSlot * slot = malloc(slots*sizeof(StrMapSlot));
+    uint32_t * hash = calloc(slots, sizeof(uint32_t));
+    if(!slot || !hash)
+    {
+        free(slot);
+        free(hash);
+        return false;
+    }
+    size_t const mask = slots-1;
+    for(size_t i = 0; map->mask && (i <= map->mask); ++i)
+    {
+        if(!map->hash[i])
+            continue;
+        size_t j = map->hash[i] & mask;
+        while(hash[j])
+            j = (j+1) & mask;
+        hash[j] = map->hash[i];
+        // strings are relocatable, short contents move with them
+        memcpy(slot + j, map->slot + i, sizeof(StrMapSlot));
+    }
+    free(map->slot);
+    free(map->hash);
+    map->slot = slot;
+    map->hash = hash;
+    map->mask = mask;
+    return true;
+}
+
+// -- Initialization --
+
+/** \brief Initialize empty map.
+ *
+ * No memory is allocated until first insertion.
+ */
+void str_map_init(StrMap * map)
+{
+    map->slot = NULL;
+    map->hash = NULL;
+    map->mask = 0;
+    map->len = 0;
+}
+
+/** \brief Kill all keys and release the table.
+ *
+ * Values are not touched, iterate over them before if they own memory.
+ */
+void str_map_kill(StrMap * map)
+{
+    for(size_t i = 0; map->mask && (i <= map->mask); ++i)
+        if(map->hash[i])
+            str_str_kill(&map->slot[i].key);
+    free(map->slot);
+    free(map->hash);
+    str_map_init(map);
+}
+
+// -- Queries --
+
+/** \brief Find value of key.
+ *
+ * \return pointer to the value or NULL if key is not present.
+ *  It is valid until the map is modified.
+ */
+void ** str_map_find(StrMap const * map, StrRef key)
+{
+    STR_REF_ASSERT(&key);
+    if(map->len == 0)
+        return NULL;
+    size_t const i = str_map_probe(map, key, str_map_hash(key));
+    return map->hash[i] ? &map->slot[i].val : NULL;
+}
+
+/** \brief Iterate over entries in table order.
+ *
+ * size_t idx = 0;
+ * for(StrMapSlot * slot; (slot = str_map_next(&map, &idx)); )
+ *     use(str_str_ref(&slot->key), slot->val);
+ *
+ * Keys must not be modified.
+ *
+ * \return next entry or NULL at the end
+ */
+StrMapSlot * str_map_next(StrMap const * map, size_t * idx)
+{
+    for(; map->mask && (*idx <= map->mask); ++*idx)
+        if(map->hash[*idx])
+            return map->slot + (*idx)++;
+    return NULL;
+}
+
+// -- Modifications --
+
+/** \brief Make room for cnt entries without rehashing.
+ *
+ * \return false if allocation failed, map is unchanged then.
+ */
+bool str_map_reserve(StrMap * map, size_t cnt)
+{
+    // load factor <= 3/4
+    if(cnt > STR_MAP_SLOTS_MAX/4*3)
+        return false;
+    size_t slots = STR_MAP_SLOTS;
+    while(slots/4*3 < cnt)
+        slots *= 2;
+    return (map->mask && (slots <= map->mask+1)) || str_map_rehash(map, slots);
+}
+
+/** \brief Slot for key, key is set by the caller if the slot was empty.
+ */
+static size_t str_map_place(StrMap * map, StrRef key, uint32_t hash, bool * added)
+{
+    size_t i = map->mask ? str_map_probe(map, key, hash) : 0;
+    *added = !map->mask || !map->hash[i];
+    if(*added)
+    {
+        if(!str_map_reserve(map, map->len+1))
+            return SIZE_MAX;
+        i = str_map_probe(map, key, hash);
+    }
+    return i;
+}
+
+/** \brief Find value of key, insert key with NULL value if not present.
+ *
+ * Key is copied into the map by the default allocator, whatever
+ * allocator the thread has selected (see str_alloc_set_thread).
+ *
+ * \param added set to whether key was inserted, may be NULL
+ * \return pointer to the value or NULL if allocation failed
+ */
+void ** str_map_insert(StrMap * map, StrRef key, bool * added)
+{
+    STR_REF_ASSERT(&key);
+    uint32_t const hash = str_map_hash(key);
+    bool add;
+    size_t const i = str_map_place(map, key, hash, &add);
+    if(i == SIZE_MAX)
+        return NULL;
+    if(add)
+    {
+        StrMapSlot * slot = map->slot + i;
+        if(!str_map_key_init(&slot->key, key))
+        {
+            str_str_kill(&slot->key);
+            return NULL;
+        }
+        slot->val = NULL;
+        map->hash[i] = hash;
+        ++map->len;
+    }
+    if(added)
+        *added = add;
+    return &map->slot[i].val;
+}
+
+/** \brief Like str_map_insert, but takes key string.
+ *
+ * If key is inserted, it is moved into the map (e.g. interned strings,
+ * long keys don't have to be copied), otherwise it is left unchanged.
+ * Moved key keeps its storage, a weak key must outlive the map.
+ */
+void ** str_map_insert_move(StrMap * map, StrStr * key, bool * added)
+{
+    StrRef const ref = str_str_ref(key);
+    uint32_t const hash = str_map_hash(ref);
+    bool add;
+    size_t const i = str_map_place(map, ref, hash, &add);
+    if(i == SIZE_MAX)
+        return NULL;
+    if(add)
+    {
+        StrMapSlot * slot = map->slot + i;
+        str_str_init_move(&slot->key, key);
+        slot->val = NULL;
+        map->hash[i] = hash;
+        ++map->len;
+    }
+    if(added)
+        *added = add;
+    return &map->slot[i].val;
+}
+
+/** \brief Remove key.
+ *
+ * \param val receives value of removed key, may be NULL
+ * \return false if key was not present
+ */
+bool str_map_erase(StrMap * map, StrRef key, void ** val)
+{
+    STR_REF_ASSERT(&key);
+    if(map->len == 0)
+        return false;
+    size_t i = str_map_probe(map, key, str_map_hash(key));
+    if(!map->hash[i])
+        return false;
+    if(val)
+        *val = map->slot[i].val;
+    str_str_kill(&map->slot[i].key);
+    --map->len;
+    // shift following entries of the cluster back, no tombstones
+    for(size_t j = (i+1) & map->mask; map->hash[j]; j = (j+1) & map->mask)
+    {
+        size_t const home = map->hash[j] & map->mask;
+        // entry at j may move to i if i lies on its probe path
+        if(((j - home) & map->mask) >= ((j - i) & map->mask))
+        {
+            map->hash[i] = map->hash[j];
+            memcpy(map->slot + i, map->slot + j, sizeof(StrMapSlot));
+            i = j;
+        }
+    }
+    map->hash[i] = 0;
+    return true;
+}
@@ -14,6 +14,43 @@ bool str_ref_is_empty(StrRef ref);
 
 bool str_ref_cmp_eq(StrRef a, StrRef b);
 
+/** \brief Test equality ignoring ASCII case.
+ *
+ * Strings of different length are rejected without reading contents.
+ */
+bool str_ref_cmp_eq_ci(StrRef a, StrRef b);
+
+/** \brief Three-way comparison of contents, shorter prefix is less.
+ *
+ * \return <0, 0, >0 like memcmp
+ */
+int str_ref_cmp(StrRef a, StrRef b);
+
+/** \brief Three-way comparison ignoring ASCII case.
+ *
+ * Order of contents converted to lower case, like strcasecmp
+ * in the "C" locale, but shorter prefix is less.
+ *
+ * \return <0, 0, >0 like memcmp
+ */
+int str_ref_cmp_ci(StrRef a, StrRef b);
+
+/** \brief Test prefix, empty prefix always matches.
+ */
+bool str_ref_starts_with(StrRef ref, StrRef prefix);
+
+/** \brief Test suffix, empty suffix always matches.
+ */
+bool str_ref_ends_with(StrRef ref, StrRef suffix);
+
+/** \brief Test prefix ignoring ASCII case.
+ */
+bool str_ref_starts_with_ci(StrRef ref, StrRef prefix);
+
+/** \brief Test suffix ignoring ASCII case.
+ */
+bool str_ref_ends_with_ci(StrRef ref, StrRef suffix);
+
 // -- Access --
 
 size_t str_ref_len(StrRef ref);
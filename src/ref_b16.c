@@ -1,67 +1,252 @@
 #include <str/ref_b16.h>
 
+#include "cpu.h"
+
 ssize_t str_decode_b16_size(size_t len);
 
-static inline int B16_dec_char(char x)
+// Decoding
+//
+// Digits are validated without branches, errors are accumulated
+// and checked once at the end. SIMD code converts 32 (AVX2) or 16 (SSSE3)
+// characters per step : nibble is the low 4 bits plus 9 for letters,
+// pmaddubsw joins pairs of nibbles, packing makes bytes of the results.
+
+// nibble value + 1 by character, 0 for non-digits
+static uint8_t const STR_B16_VALUE[256] =
+{
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+    ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+};
+
+typedef bool StrB16DecFn(char * restrict dst, unsigned char const * restrict src, size_t len);
+
+// -- Scalar --
+
+static bool str_b16_dec_scalar(char * restrict dst, unsigned char const * restrict src, size_t len)
 {
-    x = toupper(x);
-    // ... [ 0 ... 9 ] ... [ A ... F ] ...
-    switch(x)
+    // non-digits become 0xff, the high nibble is set only by errors
+    unsigned err = 0;
+    for(size_t i = 0; i < len; ++i)
     {
-        case '0' ... '9' :
-            return x - '0';
-        case 'A' ... 'F' :
-            return x - 'A' + 10;
-        default :
-            return -1;
+        uint8_t const hi = STR_B16_VALUE[src[2*i]] - 1;
+        uint8_t const lo = STR_B16_VALUE[src[2*i+1]] - 1;
+        err |= hi | lo;
+        dst[i] = (char)(hi << 4 | lo);
     }
+    return !(err & 0xf0);
 }
 
-bool str_decode_b16(char * restrict dst, StrRef ref)
+#ifdef STR_SIMD_X86
+
+// -- SSSE3 --
+
+__attribute__((target("ssse3")))
+static bool str_b16_dec_ssse3(char * restrict dst, unsigned char const * restrict src, size_t len)
 {
-    if(ref.len%2 != 0)
+    __m128i ok = _mm_set1_epi8(-1);
+    size_t i = 0;
+    for(; i + 8 <= len; i += 8)
     {
-        return false;
+        __m128i const x = _mm_loadu_si128((__m128i const *)(src + 2*i));
+        __m128i const d = _mm_sub_epi8(x, _mm_set1_epi8('0'));
+        __m128i const digit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+        __m128i const l = _mm_sub_epi8(_mm_or_si128(x, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i const letter = _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(5)), l);
+        ok = _mm_and_si128(ok, _mm_or_si128(digit, letter));
+        __m128i const nib = _mm_add_epi8(_mm_and_si128(x, _mm_set1_epi8(0x0f)),
+            _mm_and_si128(letter, _mm_set1_epi8(9)));
+        // high nibble * 16 + low nibble in each 16-bit half
+        __m128i const val = _mm_maddubs_epi16(nib, _mm_set1_epi16(0x0110));
+        _mm_storel_epi64((__m128i *)(dst + i), _mm_packus_epi16(val, val));
     }
-    char const * const restrict src = ref.ptr;
-    for(size_t i = 0; i < ref.len/2; ++i)
+    bool const tail = str_b16_dec_scalar(dst + i, src + 2*i, len - i);
+    return tail && (_mm_movemask_epi8(ok) == 0xffff);
+}
+
+// -- AVX2 --
+
+__attribute__((target("avx2")))
+static bool str_b16_dec_avx2(char * restrict dst, unsigned char const * restrict src, size_t len)
+{
+    __m256i ok = _mm256_set1_epi8(-1);
+    size_t i = 0;
+    for(; i + 16 <= len; i += 16)
     {
-        int const a = B16_dec_char(src[2*i]);
-        if(a < 0)
-        {
-            return false;
-        }
-        int const b = B16_dec_char(src[2*i+1]);
-        if(b < 0)
-        {
-            return false;
-        }
-        dst[i] = (a<<4) + b;
+        __m256i const x = _mm256_loadu_si256((__m256i const *)(src + 2*i));
+        __m256i const d = _mm256_sub_epi8(x, _mm256_set1_epi8('0'));
+        __m256i const digit = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+        __m256i const l = _mm256_sub_epi8(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        __m256i const letter = _mm256_cmpeq_epi8(_mm256_min_epu8(l, _mm256_set1_epi8(5)), l);
+        ok = _mm256_and_si256(ok, _mm256_or_si256(digit, letter));
+        __m256i const nib = _mm256_add_epi8(_mm256_and_si256(x, _mm256_set1_epi8(0x0f)),
+            _mm256_and_si256(letter, _mm256_set1_epi8(9)));
+        __m256i const val = _mm256_maddubs_epi16(nib, _mm256_set1_epi16(0x0110));
+        // packing works within 128-bit lanes, results are in qwords 0 and 2
+        __m256i const packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(val, val), 0x08);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm256_castsi256_si128(packed));
     }
+    bool const valid = (unsigned)_mm256_movemask_epi8(ok) == 0xffffffffu;
+    _mm256_zeroupper();
+    return str_b16_dec_ssse3(dst + i, src + 2*i, len - i) && valid;
+}
+
+#endif
+
+// -- Dispatch --
+
+static StrB16DecFn str_b16_dec_resolve;
+static StrB16DecFn * str_b16_dec_impl = str_b16_dec_resolve;
+
+static bool str_b16_dec_resolve(char * restrict dst, unsigned char const * restrict src, size_t len)
+{
+#ifdef STR_SIMD_X86
+    STR_CPU_RESOLVE(str_b16_dec_impl, str_cpu_avx2() ? str_b16_dec_avx2
+        : str_cpu_ssse3() ? str_b16_dec_ssse3 : str_b16_dec_scalar);
+#else
+    STR_CPU_RESOLVE(str_b16_dec_impl, str_b16_dec_scalar);
+#endif
+    return STR_CPU_IMPL(str_b16_dec_impl)(dst, src, len);
+}
+
+/** \brief Hex decode, both letter cases are accepted.
+ *
+ * Writes len/2 bytes and zero terminator.
+ * Output is unspecified if the input is invalid.
+ *
+ * \return false for odd length or characters other than hex digits
+ */
+bool str_decode_b16(char * restrict dst, StrRef ref)
+{
+    STR_REF_ASSERT(&ref);
+    if(ref.len%2 != 0)
+        return false;
+    bool const ok = STR_CPU_IMPL(str_b16_dec_impl)(dst, (unsigned char const *)ref.ptr, ref.len/2);
     dst[ref.len/2] = '\0';
-    return true;
+    return ok;
 }
 
-void str_encode_b16(char * restrict dst, StrRef ref)
+// Encoding
+//
+// Scalar code writes both digits of a byte with one lookup in a table
+// of pairs. SIMD code splits bytes to nibbles and looks digits up with
+// pshufb, then interleaves high and low digits.
+
+#define STR_B16_DIGIT(n, a) (char)((n) < 10 ? '0' + (n) : (a) - 10 + (n))
+#define STR_B16_PAIR(x, a) { STR_B16_DIGIT((x)>>4, a), STR_B16_DIGIT((x)&15, a) }
+#define STR_B16_PAIR4(x, a) STR_B16_PAIR(x, a), STR_B16_PAIR(x+1, a), \
+    STR_B16_PAIR(x+2, a), STR_B16_PAIR(x+3, a)
+#define STR_B16_PAIR16(x, a) STR_B16_PAIR4(x, a), STR_B16_PAIR4(x+4, a), \
+    STR_B16_PAIR4(x+8, a), STR_B16_PAIR4(x+12, a)
+#define STR_B16_PAIR64(x, a) STR_B16_PAIR16(x, a), STR_B16_PAIR16(x+16, a), \
+    STR_B16_PAIR16(x+32, a), STR_B16_PAIR16(x+48, a)
+
+// digits of all bytes, lower and upper case
+static char const STR_B16_PAIRS[2][256][2] =
 {
-    static char const HEX[] = "0123456789abcdef";
-    char const * const restrict src = ref.ptr;
-    for(size_t i = 0; i < ref.len; ++i)
+    { STR_B16_PAIR64(0, 'a'), STR_B16_PAIR64(64, 'a'), STR_B16_PAIR64(128, 'a'), STR_B16_PAIR64(192, 'a') },
+    { STR_B16_PAIR64(0, 'A'), STR_B16_PAIR64(64, 'A'), STR_B16_PAIR64(128, 'A'), STR_B16_PAIR64(192, 'A') },
+};
+
+typedef void StrB16EncFn(char * restrict dst, unsigned char const * restrict src, size_t len, bool upper);
+
+// -- Scalar --
+
+static void str_b16_enc_scalar(char * restrict dst, unsigned char const * restrict src, size_t len, bool upper)
+{
+    char const (* const pairs)[2] = STR_B16_PAIRS[upper];
+    for(size_t i = 0; i < len; ++i)
+        memcpy(dst + 2*i, pairs[src[i]], 2);
+}
+
+#ifdef STR_SIMD_X86
+
+// shuffle tables, lower and upper case
+static char const STR_B16_DIGITS[2][16] =
+{
+    { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' },
+    { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' },
+};
+
+// -- SSSE3 --
+
+__attribute__((target("ssse3")))
+static void str_b16_enc_ssse3(char * restrict dst, unsigned char const * restrict src, size_t len, bool upper)
+{
+    __m128i const digits = _mm_loadu_si128((__m128i const *)STR_B16_DIGITS[upper]);
+    __m128i const nib = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+    for(; i + 16 <= len; i += 16)
     {
-        dst[2*i  ] = HEX[(src[i]>>4)&0xf];
-        dst[2*i+1] = HEX[(src[i]   )&0xf];
+        __m128i const x = _mm_loadu_si128((__m128i const *)(src + i));
+        __m128i const hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(x, 4), nib));
+        __m128i const lo = _mm_shuffle_epi8(digits, _mm_and_si128(x, nib));
+        _mm_storeu_si128((__m128i *)(dst + 2*i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(dst + 2*i + 16), _mm_unpackhi_epi8(hi, lo));
     }
-    dst[2*ref.len] = '\0';
+    str_b16_enc_scalar(dst + 2*i, src + i, len - i, upper);
 }
 
-void str_encode_B16(char * restrict dst, StrRef ref)
+// -- AVX2 --
+
+__attribute__((target("avx2")))
+static void str_b16_enc_avx2(char * restrict dst, unsigned char const * restrict src, size_t len, bool upper)
 {
-    static char const HEX[] = "0123456789ABCDEF";
-    char const * const restrict src = ref.ptr;
-    for(size_t i = 0; i < ref.len; ++i)
+    __m256i const digits = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)STR_B16_DIGITS[upper]));
+    __m256i const nib = _mm256_set1_epi8(0x0f);
+    size_t i = 0;
+    for(; i + 32 <= len; i += 32)
     {
-        dst[2*i  ] = HEX[(src[i]>>4)&0xf];
-        dst[2*i+1] = HEX[(src[i]   )&0xf];
+        __m256i const x = _mm256_loadu_si256((__m256i const *)(src + i));
+        __m256i const hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(x, 4), nib));
+        __m256i const lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(x, nib));
+        // unpacking works within 128-bit lanes : a = bytes 0-7 | 16-23, b = 8-15 | 24-31
+        __m256i const a = _mm256_unpacklo_epi8(hi, lo);
+        __m256i const b = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i *)(dst + 2*i), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + 2*i + 32), _mm256_permute2x128_si256(a, b, 0x31));
     }
+    _mm256_zeroupper();
+    str_b16_enc_ssse3(dst + 2*i, src + i, len - i, upper);
+}
+
+#endif
+
+// -- Dispatch --
+
+static StrB16EncFn str_b16_enc_resolve;
+static StrB16EncFn * str_b16_enc_impl = str_b16_enc_resolve;
+
+static void str_b16_enc_resolve(char * restrict dst, unsigned char const * restrict src, size_t len, bool upper)
+{
+#ifdef STR_SIMD_X86
+    STR_CPU_RESOLVE(str_b16_enc_impl, str_cpu_avx2() ? str_b16_enc_avx2
+        : str_cpu_ssse3() ? str_b16_enc_ssse3 : str_b16_enc_scalar);
+#else
+    STR_CPU_RESOLVE(str_b16_enc_impl, str_b16_enc_scalar);
+#endif
+    STR_CPU_IMPL(str_b16_enc_impl)(dst, src, len, upper);
+}
+
+/** \brief Hex encode using lowercase characters.
+ *
+ * Writes 2*len characters and zero terminator.
+ */
+void str_encode_b16(char * restrict dst, StrRef ref)
+{
+    STR_REF_ASSERT(&ref);
+    STR_CPU_IMPL(str_b16_enc_impl)(dst, (unsigned char const *)ref.ptr, ref.len, false);
+    dst[2*ref.len] = '\0';
+}
+
+/** \brief Hex encode using uppercase characters.
+ *
+ * Writes 2*len characters and zero terminator.
+ */
+void str_encode_B16(char * restrict dst, StrRef ref)
+{
+    STR_REF_ASSERT(&ref);
+    STR_CPU_IMPL(str_b16_enc_impl)(dst, (unsigned char const *)ref.ptr, ref.len, true);
     dst[2*ref.len] = '\0';
 }
@@ -0,0 +1,218 @@
+#include <str/ref.h>
+
+#include "cpu.h"
+
+// Substring search
+//
+// SIMD variants compare the first and the last byte of the needle
+// at 16 or 32 positions at once and check the middle only where both
+// match (W. Mula, SIMD-friendly algorithms for substring searching).
+// Positions too close to the end for a full block are left to scalar code.
+
+typedef size_t StrFindFn(char const * hay, size_t len, char const * sub, size_t n);
+
+// bytes between the first and the last one match
+static inline bool str_find_mid(char const * p, char const * sub, size_t n)
+{
+    return (n <= 2) || !memcmp(p + 1, sub + 1, n - 2);
+}
+
+// -- Scalar --
+
+static size_t str_find_scalar(char const * hay, size_t len, char const * sub, size_t n)
+{
+    assert(n >= 1 && n <= len);
+    char const * const end = hay + len - n + 1; // past the last position
+    for(char const * p = hay; p < end; ++p)
+    {
+        p = memchr(p, sub[0], end - p);
+        if(!p)
+            break;
+        if((p[n-1] == sub[n-1]) && str_find_mid(p, sub, n))
+            return p - hay;
+    }
+    return SIZE_MAX;
+}
+
+static size_t str_rfind_scalar(char const * hay, size_t len, char const * sub, size_t n)
+{
+    assert(n >= 1 && n <= len);
+    for(size_t i = len - n + 1; i-- > 0; )
+        if((hay[i] == sub[0]) && (hay[i+n-1] == sub[n-1]) && str_find_mid(hay + i, sub, n))
+            return i;
+    return SIZE_MAX;
+}
+
+#ifdef STR_SIMD_X86
+
+// -- SSE2 --
+
+__attribute__((target("sse2")))
+static size_t str_find_sse2(char const * hay, size_t len, char const * sub, size_t n)
+{
+    __m128i const first = _mm_set1_epi8(sub[0]);
+    __m128i const last = _mm_set1_epi8(sub[n-1]);
+    size_t i = 0;
+    for(; i + 16 + n - 1 <= len; i += 16)
+    {
+        __m128i const a = _mm_loadu_si128((__m128i const *)(hay + i));
+        __m128i const b = _mm_loadu_si128((__m128i const *)(hay + i + n - 1));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+        for(; mask; mask &= mask - 1)
+        {
+            size_t const pos = i + __builtin_ctz(mask);
+            if(str_find_mid(hay + pos, sub, n))
+                return pos;
+        }
+    }
+    if(i + n > len)
+        return SIZE_MAX;
+    size_t const pos = str_find_scalar(hay + i, len - i, sub, n);
+    return pos == SIZE_MAX ? pos : i + pos;
+}
+
+__attribute__((target("sse2")))
+static size_t str_rfind_sse2(char const * hay, size_t len, char const * sub, size_t n)
+{
+    __m128i const first = _mm_set1_epi8(sub[0]);
+    __m128i const last = _mm_set1_epi8(sub[n-1]);
+    size_t end = len - n + 1; // past the last position
+    for(; end >= 16; end -= 16)
+    {
+        size_t const i = end - 16;
+        __m128i const a = _mm_loadu_si128((__m128i const *)(hay + i));
+        __m128i const b = _mm_loadu_si128((__m128i const *)(hay + i + n - 1));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+        for(; mask; mask &= ~(1u << (31 - __builtin_clz(mask))))
+        {
+            size_t const pos = i + 31 - __builtin_clz(mask);
+            if(str_find_mid(hay + pos, sub, n))
+                return pos;
+        }
+    }
+    return end > 0 ? str_rfind_scalar(hay, end + n - 1, sub, n) : SIZE_MAX;
+}
+
+// -- AVX2 --
+
+__attribute__((target("avx2")))
+static size_t str_find_avx2(char const * hay, size_t len, char const * sub, size_t n)
+{
+    __m256i const first = _mm256_set1_epi8(sub[0]);
+    __m256i const last = _mm256_set1_epi8(sub[n-1]);
+    size_t i = 0;
+    for(; i + 32 + n - 1 <= len; i += 32)
+    {
+        __m256i const a = _mm256_loadu_si256((__m256i const *)(hay + i));
+        __m256i const b = _mm256_loadu_si256((__m256i const *)(hay + i + n - 1));
+        unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));
+        for(; mask; mask &= mask - 1)
+        {
+            size_t const pos = i + __builtin_ctz(mask);
+            if(str_find_mid(hay + pos, sub, n))
+                return pos;
+        }
+    }
+    if(i + n > len)
+        return SIZE_MAX;
+    _mm256_zeroupper();
+    size_t const pos = str_find_sse2(hay + i, len - i, sub, n);
+    return pos == SIZE_MAX ? pos : i + pos;
+}
+
+__attribute__((target("avx2")))
+static size_t str_rfind_avx2(char const * hay, size_t len, char const * sub, size_t n)
+{
+    __m256i const first = _mm256_set1_epi8(sub[0]);
+    __m256i const last = _mm256_set1_epi8(sub[n-1]);
+    size_t end = len - n + 1; // past the last position
+    for(; end >= 32; end -= 32)
+    {
+        size_t const i = end - 32;
+        __m256i const a = _mm256_loadu_si256((__m256i const *)(hay + i));
+        __m256i const b = _mm256_loadu_si256((__m256i const *)(hay + i + n - 1));
+        unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));
+        for(; mask; mask &= ~(1u << (31 - __builtin_clz(mask))))
+        {
+            size_t const pos = i + 31 - __builtin_clz(mask);
+            if(str_find_mid(hay + pos, sub, n))
+                return pos;
+        }
+    }
+    _mm256_zeroupper();
+    return end > 0 ? str_rfind_sse2(hay, end + n - 1, sub, n) : SIZE_MAX;
+}
+
+#endif
+
+// -- Dispatch --
+
+static StrFindFn str_find_resolve;
+static StrFindFn * str_find_impl = str_find_resolve;
+
+static size_t str_find_resolve(char const * hay, size_t len, char const * sub, size_t n)
+{
+#ifdef STR_SIMD_X86
+    STR_CPU_RESOLVE(str_find_impl, str_cpu_avx2() ? str_find_avx2
+        : str_cpu_sse2() ? str_find_sse2 : str_find_scalar);
+#else
+    STR_CPU_RESOLVE(str_find_impl, str_find_scalar);
+#endif
+    return STR_CPU_IMPL(str_find_impl)(hay, len, sub, n);
+}
+
+static StrFindFn str_rfind_resolve;
+static StrFindFn * str_rfind_impl = str_rfind_resolve;
+
+static size_t str_rfind_resolve(char const * hay, size_t len, char const * sub, size_t n)
+{
+#ifdef STR_SIMD_X86
+    STR_CPU_RESOLVE(str_rfind_impl, str_cpu_avx2() ? str_rfind_avx2
+        : str_cpu_sse2() ? str_rfind_sse2 : str_rfind_scalar);
+#else
+    STR_CPU_RESOLVE(str_rfind_impl, str_rfind_scalar);
+#endif
+    return STR_CPU_IMPL(str_rfind_impl)(hay, len, sub, n);
+}
+
+// -- Decomposition --
+
+/** \brief Find position of the first occurence of sub.
+ *
+ * Empty sub is found at 0.
+ *
+ * \return SIZE_MAX if not found.
+ */
+size_t str_ref_find(StrRef ref, StrRef sub)
+{
+    STR_REF_ASSERT(&ref);
+    STR_REF_ASSERT(&sub);
+    if(sub.len == 0)
+        return 0;
+    if(sub.len > ref.len)
+        return SIZE_MAX;
+    if(sub.len == 1)
+        return str_ref_find_c(ref, sub.ptr[0]);
+    return STR_CPU_IMPL(str_find_impl)(ref.ptr, ref.len, sub.ptr, sub.len);
+}
+
+/** \brief Find position of the last occurence of sub.
+ *
+ * Empty sub is found at the end.
+ *
+ * \return SIZE_MAX if not found.
+ */
+size_t str_ref_rfind(StrRef ref, StrRef sub)
+{
+    STR_REF_ASSERT(&ref);
+    STR_REF_ASSERT(&sub);
+    if(sub.len == 0)
+        return ref.len;
+    if(sub.len > ref.len)
+        return SIZE_MAX;
+    return STR_CPU_IMPL(str_rfind_impl)(ref.ptr, ref.len, sub.ptr, sub.len);
+}
@@ -0,0 +1,133 @@
+#include <str/ref_hash.h>
+
+#include "swar.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+// wyhash final version 4, public domain (github.com/wangyi-fudan/wyhash)
+
+static uint64_t const STR_HASH_SECRET[4] =
+{
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+    0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+static inline void str_hash_mum(uint64_t * a, uint64_t * b)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = *a;
+    r *= *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r>>64);
+#else
+    // 32-bit targets, full product from 32-bit halves
+    uint64_t const ha = *a>>32, hb = *b>>32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t const rh = ha*hb, rm0 = ha*lb, rm1 = hb*la, rl = la*lb;
+    uint64_t const t = rl + (rm0<<32);
+    uint64_t c = t < rl;
+    uint64_t const lo = t + (rm1<<32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0>>32) + (rm1>>32) + c;
+#endif
+}
+
+static inline uint64_t str_hash_mix(uint64_t a, uint64_t b)
+{
+    str_hash_mum(&a, &b);
+    return a ^ b;
+}
+
+// words are read as little endian, hashes don't depend on platform
+
+static inline uint64_t str_hash_r8(unsigned char const * p, bool ci)
+{
+    uint64_t v;
+    memcpy(&v, p, 8);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return ci ? str_swar_lower(v) : v;
+}
+
+static inline uint64_t str_hash_r4(unsigned char const * p, bool ci)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return ci ? (uint32_t)str_swar_lower(v) : v;
+}
+
+static inline uint64_t str_hash_r3(unsigned char const * p, size_t k, bool ci)
+{
+    uint64_t const v = ((uint64_t)p[0]<<16) | ((uint64_t)p[k>>1]<<8) | p[k-1];
+    return ci ? str_swar_lower(v) : v;
+}
+
+static inline uint64_t str_hash(unsigned char const * p, size_t len, uint64_t seed, bool ci)
+{
+    uint64_t const * s = STR_HASH_SECRET;
+    seed ^= str_hash_mix(seed ^ s[0], s[1]);
+    uint64_t a, b;
+    if(__builtin_expect(len <= 16, 1))
+    {
+        if(len >= 4)
+        {
+            a = (str_hash_r4(p, ci)<<32) | str_hash_r4(p + ((len>>3)<<2), ci);
+            b = (str_hash_r4(p + len - 4, ci)<<32) | str_hash_r4(p + len - 4 - ((len>>3)<<2), ci);
+        }
+        else if(len > 0)
+        {
+            a = str_hash_r3(p, len, ci);
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else
+    {
+        size_t i = len;
+        if(i >= 48)
+        {
+            // three independent lanes keep the multipliers busy
+            uint64_t see1 = seed, see2 = seed;
+            do
+            {
+                seed = str_hash_mix(str_hash_r8(p, ci) ^ s[1], str_hash_r8(p + 8, ci) ^ seed);
+                see1 = str_hash_mix(str_hash_r8(p + 16, ci) ^ s[2], str_hash_r8(p + 24, ci) ^ see1);
+                see2 = str_hash_mix(str_hash_r8(p + 32, ci) ^ s[3], str_hash_r8(p + 40, ci) ^ see2);
+                p += 48;
+                i -= 48;
+            }
+            while(i >= 48);
+            seed ^= see1 ^ see2;
+        }
+        while(i > 16)
+        {
+            seed = str_hash_mix(str_hash_r8(p, ci) ^ s[1], str_hash_r8(p + 8, ci) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = str_hash_r8(p + i - 16, ci);
+        b = str_hash_r8(p + i - 8, ci);
+    }
+    a ^= s[1];
+    b ^= seed;
+    str_hash_mum(&a, &b);
+    return str_hash_mix(a ^ s[0] ^ len, b ^ s[1]);
+}
+
+uint64_t str_ref_hash(StrRef ref, uint64_t seed)
+{
+    STR_REF_ASSERT(&ref);
+    return str_hash((unsigned char const *)ref.ptr, ref.len, seed, false);
+}
+
+uint64_t str_ref_hash_ci(StrRef ref, uint64_t seed)
+{
+    STR_REF_ASSERT(&ref);
+    return str_hash((unsigned char const *)ref.ptr, ref.len, seed, true);
+}
@@ -0,0 +1,99 @@
+#include <str/ref.h>
+
+#include "cpu.h"
+#include "split.h"
+
+typedef void StrSplitFn(char const * ptr, size_t len, size_t i, char c, StrSplitOut * o);
+
+// -- Scalar --
+
+static void str_split_scalar(char const * ptr, size_t len, size_t i, char c, StrSplitOut * o)
+{
+    for(; (i < len) && (o->k < o->cnt); ++i)
+    {
+        char const * const sep = memchr(ptr + i, c, len - i);
+        if(!sep)
+            break;
+        i = sep - ptr;
+        str_split_emit(o, ptr, i);
+    }
+}
+
+#ifdef STR_SIMD_X86
+
+// -- SSE2 --
+
+__attribute__((target("sse2")))
+static void str_split_sse2(char const * ptr, size_t len, size_t i, char c, StrSplitOut * o)
+{
+    __m128i const sep = _mm_set1_epi8(c);
+    for(; (i + 16 <= len) && (o->k < o->cnt); i += 16)
+    {
+        __m128i const x = _mm_loadu_si128((__m128i const *)(ptr + i));
+        str_split_emit_mask(o, ptr, i, (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, sep)));
+    }
+    str_split_scalar(ptr, len, i, c, o);
+}
+
+// -- AVX2 --
+
+__attribute__((target("avx2")))
+static void str_split_avx2(char const * ptr, size_t len, size_t i, char c, StrSplitOut * o)
+{
+    __m256i const sep = _mm256_set1_epi8(c);
+    for(; (i + 64 <= len) && (o->k < o->cnt); i += 64)
+    {
+        __m256i const a = _mm256_loadu_si256((__m256i const *)(ptr + i));
+        __m256i const b = _mm256_loadu_si256((__m256i const *)(ptr + i + 32));
+        uint64_t const mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, sep))
+            | (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, sep)) << 32;
+        str_split_emit_mask(o, ptr, i, mask);
+    }
+    _mm256_zeroupper();
+    str_split_sse2(ptr, len, i, c, o);
+}
+
+#endif
+
+// -- Dispatch --
+
+static StrSplitFn str_split_resolve;
+static StrSplitFn * str_split_impl = str_split_resolve;
+
+static void str_split_resolve(char const * ptr, size_t len, size_t i, char c, StrSplitOut * o)
+{
+#ifdef STR_SIMD_X86
+    STR_CPU_RESOLVE(str_split_impl, str_cpu_avx2() ? str_split_avx2
+        : str_cpu_sse2() ? str_split_sse2 : str_split_scalar);
+#else
+    STR_CPU_RESOLVE(str_split_impl, str_split_scalar);
+#endif
+    STR_CPU_IMPL(str_split_impl)(ptr, len, i, c, o);
+}
+
+// -- Decomposition --
+
+/** \brief Cut up to cnt words at once.
+ *
+ * Fields are the parts between separators, the string is scanned only
+ * once. n separators give n+1 fields, so leading and trailing separators
+ * give empty first and last fields, empty string gives one empty field
+ * and null string gives none. Returned fields and their separators are
+ * removed from ref, ref becomes null after the last field.
+ *
+ * StrRef lines[64];
+ * for(size_t n; (n = str_ref_split_c(&text, '\n', lines, 64)); )
+ *     for(size_t i = 0; i < n; ++i)
+ *         foo(lines[i]);
+ *
+ * \return number of fields stored to out
+ */
+size_t str_ref_split_c(StrRef * ref, char c, StrRef * out, size_t cnt)
+{
+    STR_REF_ASSERT(ref);
+    if(!ref->ptr || !cnt)
+        return 0;
+    StrSplitOut o = { out, cnt, 0, 0 };
+    STR_CPU_IMPL(str_split_impl)(ref->ptr, ref->len, 0, c, &o);
+    return str_split_finish(&o, ref);
+}
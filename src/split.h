@@ -0,0 +1,54 @@
+#ifndef LIBSTR_SPLIT_H_INCLUDED
+#define LIBSTR_SPLIT_H_INCLUDED
+
+// Internal header, bulk splitting into caller's array.
+//
+// Scanners find separators a block at a time and emit fields for all
+// bits of the block mask, there is no call or search restart per field.
+
+#include <str/ref.h>
+
+/** \brief Fields emitted so far.
+ */
+typedef struct
+{
+    StrRef * out;
+    size_t cnt; // capacity of out
+    size_t k; // fields emitted
+    size_t beg; // start of the current field
+} StrSplitOut;
+
+/** \brief Emit field ending at separator at pos.
+ */
+static inline void str_split_emit(StrSplitOut * o, char const * ptr, size_t pos)
+{
+    assert(o->k < o->cnt);
+    o->out[o->k++] = str_ref(ptr + o->beg, pos - o->beg);
+    o->beg = pos + 1;
+}
+
+/** \brief Emit fields for separators at bits of mask, block starts at pos.
+ */
+static inline void str_split_emit_mask(StrSplitOut * o, char const * ptr, size_t pos, uint64_t mask)
+{
+    for(; mask && (o->k < o->cnt); mask &= mask - 1)
+        str_split_emit(o, ptr, pos + __builtin_ctzll(mask));
+}
+
+/** \brief Emit the last field if there is room, update ref to the rest.
+ *
+ * Scanner stopped either at the end of ref or when out was full.
+ */
+static inline size_t str_split_finish(StrSplitOut * o, StrRef * ref)
+{
+    if(o->k < o->cnt)
+    {
+        o->out[o->k++] = str_ref_tail(*ref, o->beg);
+        *ref = str_ref_null();
+    }
+    else
+        *ref = str_ref_tail(*ref, o->beg);
+    return o->k;
+}
+
+#endif//LIBSTR_SPLIT_H_INCLUDED
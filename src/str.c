@@ -1,6 +1,9 @@
 #define _ISOC99_SOURCE
+#define _GNU_SOURCE // fopencookie
 #include <str/str.h>
 
+#include "grow.h"
+
 #include <stdio.h>
 
 /** \brief Get content type.
@@ -26,6 +29,17 @@ void str_str_set_len(StrStr * str, int len);
 void str_str_set_tag_len_cap(StrStr * str, StrTag tag, int len, int cap);
 void str_str_set_len_cap(StrStr * str, int len, int cap);
 
+/** \brief Is ptr[len] readable?
+ */
+bool str_str_get_rterm(StrStr const * str);
+void str_str_set_rterm(StrStr * str);
+
+/** \brief Is '\0' known to be absent from the contents?
+ */
+bool str_str_get_nul_free(StrStr const * str);
+void str_str_set_nul_free(StrStr * str, bool nul_free);
+char * str_str_get_heap(StrStr const * str);
+
 bool str_str_is_null(StrStr const * str);
 bool str_str_is_empty(StrStr const * str);
 bool str_str_is_mutable(StrStr const * str);
@@ -69,19 +83,276 @@ void str_str_init_weak(StrStr * str, char * ptr, int len, unsigned cap);
  */
 void str_str_init_const(StrStr * str, StrRef ref);
 
+/** \brief Initialize string by copy of ref.
+ */
+bool str_str_init_copy(StrStr * str, StrRef ref);
+
+/** \brief Initialize as weak constant reference with readable terminator.
+ */
+void str_str_init_const_rterm(StrStr * str, StrRef ref);
+
+/** \brief Initialize as weak constant reference to part of another string.
+ */
+void str_str_init_substr(StrStr * dst, StrStr const * src, size_t idx, size_t len);
+
+// block shared by strings from str_str_init_copy_n
+typedef struct StrCopyHdr_s
+{
+    StrAlloc const * alloc;
+    size_t size;
+} StrCopyHdr;
+
+/** \brief Initialize array of strings by copies of refs.
+ *
+ * Long contents of all strings are stored in one block allocated from
+ * the current allocator, the strings reference it weakly (and mutably).
+ * Short ones are stored inside.
+ *
+ * The strings must be released together by str_str_kill_n,
+ * the block must outlive them.
+ *
+ * StrStr strs[3];
+ * void * mem;
+ * str_str_init_copy_n(strs, refs, 3, &mem);
+ * ...
+ * str_str_kill_n(strs, 3, mem);
+ *
+ * \param mem receives the block or NULL if it was not needed.
+ * \return false if some ref is too big or allocation failed,
+ *  strings are not initialized then.
+ */
+bool str_str_init_copy_n(StrStr * dst, StrRef const * src, size_t cnt, void ** mem)
+{
+    // sum long contents including terminators
+    size_t size = sizeof(StrCopyHdr);
+    for(size_t i = 0; i < cnt; ++i)
+    {
+        STR_REF_ASSERT(src + i);
+        if(src[i].len > INT_MAX)
+            return false;
+        if(src[i].len > STR_SSO_CAP)
+        {
+            if(size > SIZE_MAX - src[i].len - 1)
+                return false;
+            size += src[i].len + 1;
+        }
+    }
+    char * ptr = NULL;
+    if(size > sizeof(StrCopyHdr))
+    {
+        StrAlloc const * alloc = str_alloc_get();
+        StrCopyHdr * hdr = alloc->alloc(alloc->ctx, size);
+        if(!hdr)
+            return false;
+        hdr->alloc = alloc;
+        hdr->size = size;
+        ptr = (char*)(hdr + 1);
+    }
+    *mem = ptr ? ptr - sizeof(StrCopyHdr) : NULL;
+    for(size_t i = 0; i < cnt; ++i)
+    {
+        if(src[i].len > STR_SSO_CAP)
+        {
+            memcpy(ptr, src[i].ptr, src[i].len);
+            dst[i].rep.ptr = ptr;
+            // too long for weak capacity, make it const (it is zero-term)
+            int const cap = src[i].len <= STR_REF_CAP_MAX ? src[i].len : 0;
+            str_str_set_tag_len_cap(dst + i, STR_TAG_REF, src[i].len, cap);
+            if(cap == 0)
+                str_str_set_rterm(dst + i);
+            ptr += src[i].len;
+            *ptr++ = '\0';
+        }
+        else
+        {
+            bool const ok = str_str_init_copy(dst + i, src[i]);
+            assert(ok); (void)ok;
+        }
+    }
+    return true;
+}
+
 // -- Deinitialization --
 
 void str_str_kill(StrStr * str);
 
+/** \brief Kill strings from str_str_init_copy_n and release their block.
+ */
+void str_str_kill_n(StrStr * str, size_t cnt, void * mem)
+{
+    for(size_t i = 0; i < cnt; ++i)
+        str_str_kill(str + i);
+    StrCopyHdr * hdr = mem;
+    if(hdr && hdr->alloc->free)
+        hdr->alloc->free(hdr->alloc->ctx, hdr, hdr->size);
+}
+
 // -- Assignment --
 
 void str_str_set_null(StrStr * str);
 void str_str_set_empty(StrStr * str);
 void str_str_set_weak(StrStr * str, char * ptr, int len, unsigned cap);
+void str_str_set_const(StrStr * str, StrRef ref);
+void str_str_set_const_rterm(StrStr * str, StrRef ref);
+
+// -- Sharing --
+
+/** \brief Header of shared block, data follow.
+ */
+typedef struct StrShrHdr_s
+{
+    size_t refs; // atomic
+    StrAlloc const * alloc;
+} StrShrHdr;
+
+static inline StrShrHdr * str_str_shr_hdr(StrStr const * str)
+{
+    assert(str_str_get_tag(str) == STR_TAG_SHR);
+    return (StrShrHdr*)str_str_get_ptr(str) - 1;
+}
+
+/** \brief Drop reference to shared block, free it with the last one.
+ */
+void str_str_release(StrStr * str)
+{
+    StrShrHdr * hdr = str_str_shr_hdr(str);
+    if(__atomic_sub_fetch(&hdr->refs, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        if(hdr->alloc->free)
+            hdr->alloc->free(hdr->alloc->ctx, hdr,
+                sizeof(StrShrHdr) + str_str_get_cap(str) + 1u);
+    }
+}
+
+/** \brief Make shared contents exclusively owned.
+ *
+ * If there are other owners, contents are copied with the same capacity.
+ *
+ * \return mutable data pointer or NULL if allocation failed
+ */
+char * str_str_unshare(StrStr * str)
+{
+    StrShrHdr * hdr = str_str_shr_hdr(str);
+    if(__atomic_load_n(&hdr->refs, __ATOMIC_ACQUIRE) == 1)
+        return (char *)str_str_get_ptr(str);
+    int const len = str_str_get_len(str);
+    int const cap = str_str_get_cap(str);
+    StrAlloc const * alloc = str_alloc_get();
+    if(!alloc->free && (cap > STR_REF_CAP_MAX))
+        return NULL; // weak capacity has 30 bits
+    char * ptr = str_heap_alloc(alloc, cap+1u);
+    if(!ptr)
+        return NULL;
+    char * dat = (char*)((uintptr_t)ptr & ~STR_PTR_FLAGS);
+    memcpy(dat, str_str_get_ptr(str), len+1u);
+    str_str_release(str);
+    str->rep.ptr = ptr;
+    str_str_set_tag_len_cap(str, alloc->free ? STR_TAG_STR : STR_TAG_REF, len, cap);
+    return dat;
+}
+
+/** \brief Is the contents block shared (refcounted)?
+ */
+bool str_str_is_shared(StrStr const * str)
+{
+    STR_STR_ASSERT(str);
+    return str_str_get_tag(str) == STR_TAG_SHR;
+}
+
+/** \brief Move long strong contents into shared block.
+ */
+static bool str_str_make_shared(StrStr * str)
+{
+    assert(str_str_get_tag(str) == STR_TAG_STR);
+    int const len = str_str_get_len(str);
+    StrAlloc const * alloc = str_alloc_get();
+    StrShrHdr * hdr = alloc->alloc(alloc->ctx, sizeof(StrShrHdr) + len + 1u);
+    if(!hdr)
+        return false;
+    assert(((uintptr_t)hdr & STR_PTR_FLAGS) == 0);
+    hdr->refs = 1;
+    hdr->alloc = alloc;
+    memcpy(hdr + 1, str_str_get_ptr(str), len+1u);
+    str_str_kill(str);
+    str->rep.ptr = (char*)(hdr + 1);
+    str_str_set_tag_len_cap(str, STR_TAG_SHR, len, len);
+    return true;
+}
+
+/** \brief Initialize string as copy of another string, sharing contents.
+ *
+ * Long strong contents of src are moved into a refcounted block first,
+ * then both strings share it and copies are O(1) and thread safe.
+ * The first modification of a shared string copies the contents.
+ *
+ * Short strings are copied, const references are copied as references,
+ * mutable weak references are copied by value.
+ *
+ * \return false if allocation failed, dst is null then and src is unchanged.
+ */
+bool str_str_init_share(StrStr * restrict dst, StrStr * restrict src)
+{
+    STR_STR_ASSERT(src);
+    switch(str_str_get_tag(src))
+    {
+        case STR_TAG_STR :
+            if(str_str_get_len(src) <= (int)STR_SSO_CAP)
+                return str_str_init_copy(dst, str_str_ref(src));
+            if(!str_str_make_shared(src))
+            {
+                str_str_init_null(dst);
+                return false;
+            }
+            // fallthrough
+        case STR_TAG_SHR :
+            __atomic_add_fetch(&str_str_shr_hdr(src)->refs, 1, __ATOMIC_RELAXED);
+            // fallthrough
+        case STR_TAG_SSO :
+            memcpy(dst, src, sizeof(StrStr));
+            return true;
+        case STR_TAG_REF :
+            if(str_str_get_cap(src) == 0)
+            {
+                memcpy(dst, src, sizeof(StrStr));
+                return true;
+            }
+            return str_str_init_copy(dst, str_str_ref(src));
+    }
+    assert(false);
+    return false;
+}
+
+/** \brief Assign copy of another string, sharing contents.
+ */
+bool str_str_set_share(StrStr * restrict dst, StrStr * restrict src)
+{
+    str_str_kill(dst);
+    return str_str_init_share(dst, src);
+}
 
 // -- Allocation --
 
+/** \brief Allocate storage for cap characters, keep len characters.
+ *
+ * Uses allocator of the calling thread for new blocks (see str_alloc_get).
+ */
 bool str_str_alloc(StrStr * str, int cap, int len)
+{
+    return str_str_alloc_with(str, str_alloc_get(), cap, len);
+}
+
+/** \brief Allocate storage using given allocator.
+ *
+ * New heap blocks come from alloc and carry it, so the string is freed
+ * correctly whatever allocator is selected at that time.
+ * Own heap block is resized by the allocator it came from.
+ *
+ * If alloc has no free function, it owns the memory (e.g. StrArena).
+ * Such strings are weak (STR_TAG_REF) and die with the allocator.
+ * Its realloc is only asked to extend weak buffers in place,
+ * it must return NULL for blocks it can't extend or doesn't know.
+ */
+bool str_str_alloc_with(StrStr * str, StrAlloc const * alloc, int cap, int len)
 {
     STR_STR_ASSERT(str);
     if(cap < 0) // cap < 0 = guess required size
@@ -103,70 +374,423 @@ bool str_str_alloc(StrStr * str, int cap, int len)
     {
         if(cap <= (int)STR_SSO_CAP)
         {
+            if(len < 0) // short string always has length
+                len = 0;
             if(str_str_get_tag(str) != STR_TAG_SSO)
             {
                 StrStr old;
                 memcpy(&old, str, sizeof(StrStr));
-                if(len >= 0)
-                    memcpy(str->sso.dat, old.rep.ptr, len);
+                if(len > 0)
+                    memcpy(str->sso.dat, str_str_get_ptr(&old), len);
                 str_str_set_tag(str, STR_TAG_SSO);
                 str_str_kill(&old);
             }
-            if(len >= 0)
-            {
-                ((char*)str_str_get_ptr(str))[len] = '\0';
-                str_str_set_len(str, len);
-            }
+            ((char*)str_str_get_ptr(str))[len] = '\0';
+            str_str_set_len(str, len);
         }
         else
         {
-            char * ptr = malloc(cap+1u);
-            if(!ptr)
-                return false;
-            if(len >= 0)
+            // allocators without free own the memory (arenas)
+            // - their blocks are referenced weakly, kill is no-op
+            StrTag tag = alloc->free ? STR_TAG_STR : STR_TAG_REF;
+            char * ptr = NULL;
+            if((str_str_get_tag(str) == STR_TAG_STR) && (len > 0))
             {
-                memcpy(ptr, str_str_get_ptr(str), len);
-                ptr[len] = '\0';
+                // own buffer with contents to keep
+                // - realloc can grow in place or remap pages instead of copying
+                ptr = str_heap_realloc(str_str_get_heap(str), str_str_get_cap(str)+1u, cap+1u);
+                if(!ptr)
+                    return false;
+                tag = STR_TAG_STR;
             }
-            str_str_kill(str);
+            else
+            {
+                if((tag == STR_TAG_REF) && (cap > STR_REF_CAP_MAX))
+                    return false; // weak capacity has 30 bits
+                if((tag == STR_TAG_REF) && alloc->realloc && (len > 0)
+                    && (str_str_get_tag(str) == STR_TAG_REF) && (str_str_get_cap(str) > 0))
+                {
+                    // weak buffer may be the last block of an arena, try to extend it
+                    ptr = alloc->realloc(alloc->ctx, str->rep.ptr, str_str_get_cap(str)+1u, cap+1u);
+                }
+                if(!ptr)
+                {
+                    ptr = str_heap_alloc(alloc, cap+1u);
+                    if(!ptr)
+                        return false;
+                    if(len > 0)
+                        memcpy((char*)((uintptr_t)ptr & ~STR_PTR_FLAGS), str_str_get_ptr(str), len);
+                }
+                str_str_kill(str);
+            }
+            if(len < 0)
+                len = 0;
+            ((char*)((uintptr_t)ptr & ~STR_PTR_FLAGS))[len] = '\0';
             str->rep.ptr = ptr;
-            str_str_set_tag_len_cap(str, STR_TAG_STR, len < 0 ? 0 : len, cap);
+            str_str_set_tag_len_cap(str, tag, len, cap);
         }
     }
     assert(str_str_cap(str) >= cap); // PRE str ok
     return true;
 }
 
+/** \brief Capacity growth factor in percent.
+ *
+ * Used by str_str_grow and str_big_grow, 100 means exact allocation.
+ */
+static unsigned str_str_growth = 200;
+
+size_t str_grow_cap(size_t old_cap, size_t cap, size_t max)
+{
+    size_t const percent = str_str_growth;
+    // old_cap*percent/100 without overflow
+    size_t const want = old_cap/100 <= max/percent
+        ? old_cap/100*percent + old_cap%100*percent/100 : max;
+    return want > max ? max : want > cap ? want : cap;
+}
+
+/** \brief Set capacity growth factor used by appending functions.
+ *
+ * Applies to StrStr and StrBig.
+ *
+ * percent == 100 - allocate exactly what is needed (quadratic appends)
+ * percent == 150 - grow capacity at least 1.5x
+ * percent == 200 - grow capacity at least 2x (default)
+ *
+ * Values below 100 are treated as 100.
+ * Not thread safe, should be set before strings are used.
+ *
+ * \return previous growth factor
+ */
+unsigned str_str_set_growth(unsigned percent)
+{
+    unsigned const old = str_str_growth;
+    str_str_growth = percent < 100 ? 100 : percent;
+    return old;
+}
+
+/** \brief Ensure capacity for at least cap characters, keep contents.
+ *
+ * Capacity of mutable strings grows geometrically (see str_str_set_growth)
+ * so repeated appends are amortized O(1). Growth is capped at INT_MAX.
+ * Immutable strings are copied with exact capacity.
+ *
+ * \return false if allocation failed, string is unchanged in such case.
+ */
+bool str_str_grow(StrStr * str, int cap)
+{
+    STR_STR_ASSERT(str);
+    assert(cap >= 0);
+    int const old_cap = str_str_get_cap(str);
+    if((cap <= old_cap) && (old_cap > 0))
+        return true;
+    if(old_cap > 0)
+        cap = str_grow_cap(old_cap, cap, INT_MAX);
+    return str_str_alloc(str, cap, INT_MAX);
+}
+
+/** \brief Ensure capacity for at least cap characters, keep contents.
+ *
+ * Unlike str_str_grow, capacity is exactly cap if the string grows,
+ * use it to pre-size a string to its expected final length.
+ * Immutable strings are copied even if cap is smaller than their length,
+ * cap == 0 included. Empty immutable strings have nothing to copy.
+ *
+ * \return false if allocation failed, string is unchanged in such case.
+ */
+bool str_str_reserve(StrStr * str, int cap)
+{
+    STR_STR_ASSERT(str);
+    assert(cap >= 0);
+    int const old_cap = str_str_get_cap(str);
+    if((cap <= old_cap) && (old_cap > 0)) // immutable strings have cap == 0
+        return true;
+    if(cap < str_str_get_len(str)) // copy of immutable contents
+        cap = str_str_get_len(str);
+    return str_str_alloc(str, cap, INT_MAX);
+}
+
+/** \brief Release unused capacity of strong string.
+ *
+ * Short contents move inside the string, the block is freed.
+ * Longer ones are reallocated to exactly len+1 bytes by the allocator
+ * they came from. Weak and shared strings don't own their block alone,
+ * they are left unchanged.
+ *
+ * \return false if reallocation failed, string is unchanged in such case.
+ */
+bool str_str_shrink_to_fit(StrStr * str)
+{
+    STR_STR_ASSERT(str);
+    if(str_str_get_tag(str) != STR_TAG_STR)
+        return true;
+    int const len = str_str_get_len(str);
+    int const cap = str_str_get_cap(str);
+    if(len <= (int)STR_SSO_CAP)
+    {
+        StrStr old;
+        memcpy(&old, str, sizeof(StrStr));
+        memcpy(str->sso.dat, str_str_get_ptr(&old), len);
+        // for full string, terminator is the length byte
+        ((char*)str)[len] = '\0';
+        str->sso.len = STR_SSO_CAP - len;
+        str_str_kill(&old);
+        return true;
+    }
+    if(cap == len)
+        return true;
+    bool const nul_free = str_str_get_nul_free(str);
+    char * ptr = str_heap_realloc(str_str_get_heap(str), cap+1u, len+1u);
+    if(!ptr)
+        return false;
+    str->rep.ptr = ptr;
+    str_str_set_len_cap(str, len, len);
+    str_str_set_nul_free(str, nul_free);
+    return true;
+}
+
 // -- Modification --
 
 char const * str_str_cstr(StrStr * str);
 bool str_str_cat(StrStr * str, StrRef ref);
 
+/** \brief Append cnt pieces.
+ *
+ * Total length is computed first, so the string grows at most once.
+ *
+ * \return false if result is too long or allocation failed,
+ *  string is unchanged then.
+ */
+bool str_str_catv(StrStr * str, StrRef const * refs, size_t cnt)
+{
+    int const str_len = str_str_len(str);// PRE str ok
+    size_t add = 0;
+    for(size_t i = 0; i < cnt; ++i)
+    {
+        STR_REF_ASSERT(refs + i);
+        // str->len + add <= INT_MAX
+        if(refs[i].len > (size_t)(INT_MAX-str_len) - add)
+            return false;
+        add += refs[i].len;
+    }
+    if(add == 0) // nothing to append, don't touch storage
+        return true;
+    if(((int)add > str_str_get_cap(str)-str_len) && !str_str_grow(str, str_len+add))
+        return false;
+    char * ptr = str_str_ptr_mut(str);// shared contents are copied here
+    if(!ptr)
+        return false;
+    ptr += str_len;
+    for(size_t i = 0; i < cnt; ++i)
+    {
+        if(refs[i].len == 0) // null pieces have NULL ptr
+            continue;
+        memcpy(ptr, refs[i].ptr, refs[i].len);
+        ptr += refs[i].len;
+    }
+    *ptr = '\0';
+    str_str_set_len(str, str_len+add);
+    return true;
+}
+
+/** \brief Format string, printf-like.
+ *
+ * Output is first formatted into current storage,
+ * if it doesn't fit, the string is reallocated and formatted again.
+ *
+ * \return false on formatting or allocation error, string is null then.
+ */
 bool str_str_fmt(StrStr * str, char const * fmt, ...)
 {
+    va_list args;
+    va_start(args, fmt);
+    bool const ok = str_str_vfmt(str, fmt, args);
+    va_end(args);
+    return ok;
+}
+
+bool str_str_vfmt(StrStr * str, char const * fmt, va_list args)
+{
+    if(str_str_get_tag(str) == STR_TAG_SHR) // don't copy contents to be overwritten
+        str_str_set_empty(str);
     char * ptr = str_str_ptr_mut(str);// PRE str ok
     unsigned const cap = ptr ? str_str_cap(str)+1u : 0;
-    va_list args;
+    va_list again;
+    va_copy(again, args);
     // first try
-    va_start(args, fmt);
     int const len = vsnprintf(ptr, cap, fmt, args);
-    va_end(args);
     bool ok = len >= 0;
+    if(ok && (len == 0) && !ptr) // immutable string, empty output needs no storage
+    {
+        va_end(again);
+        str_str_kill(str);
+        str_str_init_empty(str);
+        return true;
+    }
     if(ok && ((unsigned)len >= cap)) // string is too small
     {
-        str_str_set_len(str, cap>0 ? cap-1 : 0);
-        if(str_str_alloc(str, len, len))
+        // old contents are not needed
+        ok = str_str_alloc(str, len, -1);
+        if(ok)
         {
             ptr = str_str_ptr_mut(str);
             // retry
-            va_start(args, fmt);
-            ok = vsnprintf(ptr, len+1u, fmt, args) == len;
-            va_end(args);
+            ok = ptr && (vsnprintf(ptr, len+1u, fmt, again) == len);
         }
     }
+    va_end(again);
     if(ok)
         str_str_set_len(str, len);
     else
         str_str_set_null(str);
     return ok;
 }
+
+/** \brief Append formatted string, printf-like.
+ *
+ * Output is formatted into spare capacity after current contents,
+ * if it doesn't fit, the string grows geometrically and the output
+ * is formatted again.
+ *
+ * \return false on formatting or allocation error, contents are kept then.
+ */
+bool str_str_fmt_cat(StrStr * str, char const * fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    bool const ok = str_str_vfmt_cat(str, fmt, args);
+    va_end(args);
+    return ok;
+}
+
+bool str_str_vfmt_cat(StrStr * str, char const * fmt, va_list args)
+{
+    int const str_len = str_str_len(str);// PRE str ok
+    // shared contents are copied only if something is appended
+    char * ptr = str_str_get_tag(str) == STR_TAG_SHR ? NULL : str_str_ptr_mut(str);
+    unsigned const spare = ptr ? (unsigned)(str_str_cap(str)-str_len)+1u : 0;
+    va_list again;
+    va_copy(again, args);
+    // first try
+    int const len = vsnprintf(ptr ? ptr+str_len : NULL, spare, fmt, args);
+    bool ok = (len >= 0) && (len <= INT_MAX-str_len);
+    if(ok && (len == 0)) // nothing to append, don't touch storage
+    {
+        va_end(again);
+        return true;
+    }
+    if(ok && ((unsigned)len >= spare)) // not enough spare capacity
+    {
+        if(ptr) // drop partial output
+            ptr[str_len] = '\0';
+        ok = str_str_grow(str, str_len+len);
+        if(ok)
+        {
+            ptr = str_str_ptr_mut(str);
+            // retry
+            ok = ptr && (vsnprintf(ptr+str_len, len+1u, fmt, again) == len);
+        }
+    }
+    va_end(again);
+    if(ok)
+        str_str_set_len(str, str_len+len);
+    else if(ptr)
+        ptr[str_len] = '\0'; // drop partial output
+    return ok;
+}
+
+#if defined(__GLIBC__)
+
+// stream output is appended to the string
+static ssize_t str_str_stream_write(void * cookie, char const * buf, size_t size)
+{
+    // 0 = error
+    return str_str_cat(cookie, str_ref(buf, size)) ? (ssize_t)size : 0;
+}
+
+#endif
+
+/** \brief Format string, printf-like, in one pass.
+ *
+ * Output is appended to the string as it is produced, the string grows
+ * geometrically (see str_str_set_growth), so formatting is done once.
+ * Opening the stream has a cost, prefer str_str_fmt for short outputs.
+ *
+ * Uses cookie stream on glibc, otherwise falls back to str_str_vfmt.
+ *
+ * \return false on formatting or allocation error, string is null then.
+ */
+bool str_str_fmt_stream(StrStr * str, char const * fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    bool const ok = str_str_vfmt_stream(str, fmt, args);
+    va_end(args);
+    return ok;
+}
+
+bool str_str_vfmt_stream(StrStr * str, char const * fmt, va_list args)
+{
+#if defined(__GLIBC__)
+    str_str_set_empty(str);// PRE str ok
+    FILE * f = fopencookie(str, "w", (cookie_io_functions_t) {
+        .read = NULL, .write = str_str_stream_write, .seek = NULL, .close = NULL });
+    // unbuffered stream formats through a stack buffer, no malloc
+    bool ok = f && (setvbuf(f, NULL, _IONBF, 0) == 0)
+        && (vfprintf(f, fmt, args) >= 0);
+    if(f)
+        ok = (fclose(f) == 0) && ok;
+    if(!ok)
+        str_str_set_null(str);
+    return ok;
+#else
+    return str_str_vfmt(str, fmt, args);
+#endif
+}
+
+/** \brief Make contents mutable for conversion in place.
+ *
+ * Immutable contents are copied, shared ones unshared.
+ */
+static char * str_str_ptr_conv(StrStr * str, int len)
+{
+    if(!str_str_is_mutable(str) && !str_str_alloc(str, len, len))
+        return NULL;
+    return str_str_ptr_mut(str);
+}
+
+/** \brief Convert ASCII letters to lower case in place.
+ *
+ * Immutable contents are copied first.
+ *
+ * \return false if copying failed, string is unchanged then.
+ */
+bool str_str_tolower(StrStr * str)
+{
+    STR_STR_ASSERT(str);
+    int const len = str_str_get_len(str);
+    if(len == 0)
+        return true;
+    char * const ptr = str_str_ptr_conv(str, len);
+    if(ptr)
+        str_ascii_tolower_n(ptr, ptr, len);
+    return ptr;
+}
+
+/** \brief Convert ASCII letters to upper case in place.
+ *
+ * Immutable contents are copied first.
+ *
+ * \return false if copying failed, string is unchanged then.
+ */
+bool str_str_toupper(StrStr * str)
+{
+    STR_STR_ASSERT(str);
+    int const len = str_str_get_len(str);
+    if(len == 0)
+        return true;
+    char * const ptr = str_str_ptr_conv(str, len);
+    if(ptr)
+        str_ascii_toupper_n(ptr, ptr, len);
+    return ptr;
+}
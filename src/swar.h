@@ -0,0 +1,24 @@
+#ifndef LIBSTR_SWAR_H_INCLUDED
+#define LIBSTR_SWAR_H_INCLUDED
+
+// Internal header, all bytes of a 64-bit word at once.
+
+#include <stdint.h>
+
+// 0x01 in all bytes
+#define STR_SWAR_ONES ((uint64_t)-1/0xff)
+
+/** \brief Convert ASCII upper case letters in all bytes to lower case.
+ */
+static inline uint64_t str_swar_lower(uint64_t x)
+{
+    uint64_t const low = x & (0x7f*STR_SWAR_ONES);
+    // msb of each byte : >= 'A', > 'Z'
+    uint64_t const ge_a = low + (0x80 - 'A')*STR_SWAR_ONES;
+    uint64_t const gt_z = low + (0x80 - 'Z' - 1)*STR_SWAR_ONES;
+    // bytes >= 0x80 are not letters
+    uint64_t const upper = ge_a & ~gt_z & ~x & (0x80*STR_SWAR_ONES);
+    return x | (upper>>2);
+}
+
+#endif//LIBSTR_SWAR_H_INCLUDED